@@ -32,6 +32,231 @@
 #define NEX_RET_INVALID_VARIABLE        (0x1A)
 #define NEX_RET_INVALID_OPERATION       (0x1B)
 
+#define NEX_FRAME_SIZE                  (40)    /* max frame stored; longer strings are truncated */
+#define NEX_EVENT_QUEUE_SIZE            (8)     /* must be a power of 2 */
+#define NEX_TX_BUFFER_SIZE              (256)   /* must be a power of 2 */
+#define NEX_COMMAND_SIZE                (40)    /* max batched command length, including terminating 0 */
+#define NEX_BATCH_SIZE                  (16)    /* max commands in a batch */
+#define NEX_MIRROR_SIZE                 (32)    /* number of attribute values mirrored; more than any one page has */
+#define NEX_BAUD_SETTLE_MS              (20)    /* time for Nextion to change baud rate */
+#define NEX_BAUD_CHECKS                 (3)     /* round trips that must work at a new baud rate */
+#define NEX_BAUD_RETRIES                (8)     /* attempts to return Nextion to the old rate */
+
+/*
+ * Return protocol decoder state. 
+ * Bytes are taken from the serial receive buffer (filled by the UART interrupt) as they arrive, 
+ * and assembled into frames ending 0xFF 0xFF 0xFF. Touch and page events are queued for nexLoop(); 
+ * anything else is a response to a command, kept until the next command is sent.
+ * With bkcmd=3 every command returns one code (success or failure). Batched commands aren't 
+ * waited for, so their codes are counted and dropped as they arrive: a code that arrives late 
+ * can't be taken as the response to a later command.
+ */
+struct NexEvent
+{
+    uint8_t head;                                       /* NEX_RET_EVENT_TOUCH_HEAD or NEX_RET_CURRENT_PAGE_ID_HEAD */
+    uint8_t pid;
+    uint8_t cid;
+    uint8_t event;
+};
+
+static uint8_t __frame[NEX_FRAME_SIZE];                 /* frame being assembled */
+static uint8_t __frame_len;                             /* bytes received in frame, including any not stored */
+static uint8_t __cnt_0xff;                              /* consecutive 0xFF bytes at end of frame */
+static uint8_t __response[NEX_FRAME_SIZE];              /* last command response, without terminators */
+static uint8_t __response_len;
+static bool __response_ready;                           /* true if a response is waiting to be read */
+static NexEvent __events[NEX_EVENT_QUEUE_SIZE];         /* queued events */
+static uint8_t __event_head;                            /* free running write and read counts */
+static uint8_t __event_tail;
+static uint16_t __replies_pending;                      /* return codes still due for batched commands */
+
+/*
+ * Transmit buffer. 
+ * Commands are queued here and passed to the serial transmit buffer as it has room, 
+ * so sending a command doesn't wait for the bytes to go out on the wire.
+ */
+static uint8_t __tx[NEX_TX_BUFFER_SIZE];
+static uint16_t __tx_head;                              /* free running write and read counts */
+static uint16_t __tx_tail;
+
+/*
+ * Command batch, sent as one burst by nexBatchFlush(). 
+ * An attribute assignment ("p2t2.txt=...") replaces an earlier one to the same attribute in the batch; 
+ * other commands are kept in order. 
+ * __mirror is a RAM copy of the value displayed by each attribute written, as the assignment last sent. 
+ * Writes are compared against it, and only the differences are sent.
+ */
+static char __batch[NEX_BATCH_SIZE][NEX_COMMAND_SIZE];
+static uint8_t __batch_count;
+static char __mirror[NEX_MIRROR_SIZE][NEX_COMMAND_SIZE];
+static uint8_t __mirror_count;
+static uint8_t __mirror_next;                           /* entry replaced when __mirror is full */
+
+
+/*
+ * Frame body length for frames whose body may contain 0xFF. 
+ * 
+ * @param head - first byte of the frame. 
+ *
+ * @return body length including the head byte, or 0 if the frame simply ends at the first 0xFF 0xFF 0xFF. 
+ */
+static uint8_t nexFixedLength(uint8_t head)
+{
+    switch (head)
+    {
+        case NEX_RET_NUMBER_HEAD:
+            return 5;
+        case NEX_RET_EVENT_TOUCH_HEAD:
+            return 4;
+        case NEX_RET_CURRENT_PAGE_ID_HEAD:
+            return 2;
+        case NEX_RET_EVENT_POSITION_HEAD:
+        case NEX_RET_EVENT_SLEEP_POSITION_HEAD:
+            return 6;
+        default:
+            return 0;
+    }
+}
+
+
+/*
+ * Handle a complete frame: queue an event, or keep it as the command response. 
+ * 
+ * @param len - frame length without the terminators. 
+ */
+static void nexFrameReceived(uint8_t len)
+{
+    NexEvent *event;
+
+    if (len == 0)
+    {
+        return;
+    }
+    if (__frame[0] == NEX_RET_EVENT_TOUCH_HEAD || __frame[0] == NEX_RET_CURRENT_PAGE_ID_HEAD)
+    {
+        if (len != nexFixedLength(__frame[0]))
+        {
+            dbSerialPrintln("nex event frame err");
+        }
+        else if ((uint8_t)(__event_head - __event_tail) >= NEX_EVENT_QUEUE_SIZE)
+        {
+            dbSerialPrintln("nex event queue full");
+        }
+        else
+        {
+            event = &__events[__event_head++ & (NEX_EVENT_QUEUE_SIZE - 1)];
+            event->head = __frame[0];
+            event->pid = __frame[1];
+            event->cid = (len > 2) ? __frame[2] : 0;
+            event->event = (len > 3) ? __frame[3] : 0;
+        }
+    }
+    else if (len == 1 && __frame[0] < NEX_RET_EVENT_LAUNCHED && __replies_pending != 0)
+    {
+        __replies_pending--;                            /* return code for a batched command */
+    }
+    else if (__frame[0] != NEX_RET_EVENT_POSITION_HEAD && __frame[0] != NEX_RET_EVENT_SLEEP_POSITION_HEAD)
+    {
+        if (len > NEX_FRAME_SIZE)
+        {
+            len = NEX_FRAME_SIZE;
+        }
+        memcpy(__response, __frame, len);
+        __response_len = len;
+        __response_ready = true;
+    }
+}
+
+
+/*
+ * Pass queued command bytes to the serial transmit buffer, as far as it has room. 
+ */
+static void nexTxService(void)
+{
+    while (__tx_tail != __tx_head && nexSerial.availableForWrite() > 0)
+    {
+        nexSerial.write(__tx[__tx_tail++ & (NEX_TX_BUFFER_SIZE - 1)]);
+    }
+}
+
+
+/*
+ * Queue a byte to send. If the transmit buffer is full, the link is serviced 
+ * until there is room: commands are never dropped, and events keep being decoded. 
+ */
+static void nexTxByte(uint8_t c)
+{
+    while ((uint16_t)(__tx_head - __tx_tail) >= NEX_TX_BUFFER_SIZE)
+    {
+        nexPoll();
+    }
+    __tx[__tx_head++ & (NEX_TX_BUFFER_SIZE - 1)] = c;
+}
+
+
+/*
+ * Service the link: send queued command bytes, and decode any bytes received from Nextion. 
+ * Never waits. 
+ */
+void nexPoll(void)
+{
+    uint8_t c;
+    uint8_t fixed;
+
+    nexTxService();
+    while (nexSerial.available() > 0)
+    {
+        c = nexSerial.read();
+        if (__frame_len < NEX_FRAME_SIZE)
+        {
+            __frame[__frame_len] = c;
+        }
+        if (__frame_len < 255)
+        {
+            __frame_len++;
+        }
+        fixed = nexFixedLength(__frame[0]);
+        if (0xFF == c && __frame_len > fixed)
+        {
+            if (++__cnt_0xff >= 3)
+            {
+                nexFrameReceived(__frame_len - 3);
+                __frame_len = 0;
+                __cnt_0xff = 0;
+            }
+        }
+        else
+        {
+            __cnt_0xff = 0;
+        }
+    }
+}
+
+
+/*
+ * Wait for a command response. 
+ * 
+ * @param timeout - set timeout time. 
+ *
+ * @retval true - a response is in __response; it is then consumed. 
+ * @retval false - timed out. 
+ */
+static bool nexWaitResponse(uint32_t timeout)
+{
+    uint32_t start = millis();
+
+    do
+    {
+        nexPoll();
+        if (__response_ready)
+        {
+            __response_ready = false;
+            return true;
+        }
+    } while (millis() - start <= timeout);
+    return false;
+}
+
 /*
  * Receive uint32_t data. 
  * 
@@ -45,26 +270,22 @@
 bool recvRetNumber(uint32_t *number, uint32_t timeout)
 {
     bool ret = false;
-    uint8_t temp[8] = {0};
 
     if (!number)
     {
         goto __return;
     }
     
-    nexSerial.setTimeout(timeout);
-    if (sizeof(temp) != nexSerial.readBytes((char *)temp, sizeof(temp)))
+    if (!nexWaitResponse(timeout))
     {
         goto __return;
     }
 
-    if (temp[0] == NEX_RET_NUMBER_HEAD
-        && temp[5] == 0xFF
-        && temp[6] == 0xFF
-        && temp[7] == 0xFF
+    if (__response[0] == NEX_RET_NUMBER_HEAD
+        && __response_len == 5
         )
     {
-        *number = ((uint32_t)temp[4] << 24) | ((uint32_t)temp[3] << 16) | (temp[2] << 8) | (temp[1]);
+        *number = ((uint32_t)__response[4] << 24) | ((uint32_t)__response[3] << 16) | (__response[2] << 8) | (__response[1]);
         ret = true;
     }
 
@@ -97,60 +318,23 @@ __return:
 uint16_t recvRetString(char *buffer, uint16_t len, uint32_t timeout)
 {
     uint16_t ret = 0;
-    bool str_start_flag = false;
-    uint8_t cnt_0xff = 0;
-    String temp = String("");
-    uint8_t c = 0;
-    long start;
 
     if (!buffer || len == 0)
     {
         goto __return;
     }
     
-    start = millis();
-    while (millis() - start <= timeout)
+    if (nexWaitResponse(timeout) && __response[0] == NEX_RET_STRING_HEAD)
     {
-        while (nexSerial.available())
-        {
-            c = nexSerial.read();
-            if (str_start_flag)
-            {
-                if (0xFF == c)
-                {
-                    cnt_0xff++;                    
-                    if (cnt_0xff >= 3)
-                    {
-                        break;
-                    }
-                }
-                else
-                {
-                    temp += (char)c;
-                }
-            }
-            else if (NEX_RET_STRING_HEAD == c)
-            {
-                str_start_flag = true;
-            }
-        }
-        
-        if (cnt_0xff >= 3)
-        {
-            break;
-        }
+        ret = __response_len - 1;
+        ret = ret > len ? len : ret;
+        strncpy(buffer, (const char *)&__response[1], ret);
     }
-
-    ret = temp.length();
-    ret = ret > len ? len : ret;
-    strncpy(buffer, temp.c_str(), ret);
     
 __return:
 
     dbSerialPrint("recvRetString[");
-    dbSerialPrint(temp.length());
-    dbSerialPrint(",");
-    dbSerialPrint(temp);
+    dbSerialPrint(ret);
     dbSerialPrintln("]");
 
     return ret;
@@ -161,17 +345,146 @@ __return:
  *
  * @param cmd - the string of command.
  */
+static void nexQueueCommand(const char* cmd)
+{
+    while (*cmd)
+    {
+        nexTxByte(*cmd++);
+    }
+    nexTxByte(0xFF);
+    nexTxByte(0xFF);
+    nexTxByte(0xFF);
+}
+
+/*
+ * Send a command whose response is waited for. Any batched commands are sent first, 
+ * so a page change can't overtake writes to the page it replaces. 
+ */
 void sendCommand(const char* cmd)
 {
-    while (nexSerial.available())
+    nexBatchFlush();
+    nexPoll();                                          /* keep any events; discard an unread response */
+    __response_ready = false;
+    nexQueueCommand(cmd);
+    nexTxService();
+}
+
+
+/*
+ * Length of the attribute part of an assignment command ("p2t2.txt" in "p2t2.txt=..."). 
+ * 
+ * @return 0 if the command isn't an attribute assignment. 
+ */
+static uint8_t nexAttributeLength(const char* cmd)
+{
+    uint8_t len;
+
+    for (len = 0; cmd[len] != 0 && cmd[len] != '=' && cmd[len] != ' '; len++)
     {
-        nexSerial.read();
     }
-    
-    nexSerial.print(cmd);
-    nexSerial.write(0xFF);
-    nexSerial.write(0xFF);
-    nexSerial.write(0xFF);
+    return (cmd[len] == '=') ? len : 0;
+}
+
+
+/*
+ * Find a command assigning the same attribute. 
+ * 
+ * @return index in list, or count if not found. 
+ */
+static uint8_t nexFindAttribute(char (*list)[NEX_COMMAND_SIZE], uint8_t count, const char* cmd, uint8_t len)
+{
+    uint8_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (list[i][len] == '=' && strncmp(list[i], cmd, len) == 0)
+        {
+            break;
+        }
+    }
+    return i;
+}
+
+
+uint8_t nexBatchCommand(const char* cmd)
+{
+    uint8_t len;
+    uint8_t i = __batch_count;
+    uint8_t j;
+    size_t cmd_len = strlen(cmd);
+
+    if (cmd_len >= NEX_COMMAND_SIZE)
+    {
+        sendCommand(cmd);                               /* too long to batch */
+        return cmd_len + 3;
+    }
+    len = nexAttributeLength(cmd);
+    if (len != 0)
+    {
+        i = nexFindAttribute(__batch, __batch_count, cmd, len);
+        j = nexFindAttribute(__mirror, __mirror_count, cmd, len);
+        if (i == __batch_count && j < __mirror_count && strcmp(__mirror[j], cmd) == 0)
+        {
+            return 0;                                   /* already displayed, and no other value pending */
+        }
+    }
+    if (i == __batch_count)
+    {
+        if (__batch_count >= NEX_BATCH_SIZE)
+        {
+            nexBatchFlush();
+        }
+        i = __batch_count++;
+    }
+    strcpy(__batch[i], cmd);
+    return cmd_len + 3;
+}
+
+
+void nexBatchFlush(void)
+{
+    uint8_t i;
+    uint8_t j;
+    uint8_t len;
+
+    nexPoll();
+    __response_ready = false;
+    for (i = 0; i < __batch_count; i++)
+    {
+        len = nexAttributeLength(__batch[i]);
+        if (len != 0)
+        {
+            j = nexFindAttribute(__mirror, __mirror_count, __batch[i], len);
+            if (j < __mirror_count && strcmp(__mirror[j], __batch[i]) == 0)
+            {
+                continue;                               /* value already displayed */
+            }
+            if (j == __mirror_count)
+            {
+                if (__mirror_count < NEX_MIRROR_SIZE)
+                {
+                    __mirror_count++;
+                }
+                else
+                {
+                    j = __mirror_next;
+                    __mirror_next = (__mirror_next + 1) % NEX_MIRROR_SIZE;
+                }
+            }
+            strcpy(__mirror[j], __batch[i]);
+        }
+        nexQueueCommand(__batch[i]);
+        __replies_pending++;
+    }
+    __batch_count = 0;
+    nexTxService();
+}
+
+
+void nexInvalidateMirror(void)
+{
+    __mirror_count = 0;
+    __mirror_next = 0;
 }
 
 
@@ -187,18 +500,10 @@ void sendCommand(const char* cmd)
 bool recvRetCommandFinished(uint32_t timeout)
 {    
     bool ret = false;
-    uint8_t temp[4] = {0};
     
-    nexSerial.setTimeout(timeout);
-    if (sizeof(temp) != nexSerial.readBytes((char *)temp, sizeof(temp)))
-    {
-        ret = false;
-    }
-
-    if (temp[0] == NEX_RET_CMD_FINISHED
-        && temp[1] == 0xFF
-        && temp[2] == 0xFF
-        && temp[3] == 0xFF
+    if (nexWaitResponse(timeout)
+        && __response[0] == NEX_RET_CMD_FINISHED
+        && __response_len == 1
         )
     {
         ret = true;
@@ -217,51 +522,111 @@ bool recvRetCommandFinished(uint32_t timeout)
 }
 
 
+bool nexProbe(uint32_t baud)
+{
+    nexSerial.begin(baud);
+    while (nexSerial.available() > 0)                   /* discard anything received at the old rate */
+    {
+        nexSerial.read();
+    }
+    __frame_len = 0;
+    __cnt_0xff = 0;
+    __replies_pending = 0;
+    sendCommand("");                                    /* ends any partial command; wait for its error code */
+    nexWaitResponse(NEX_BAUD_SETTLE_MS);
+    sendCommand("bkcmd=3");
+    return recvRetCommandFinished();
+}
+
+
+/*
+ * Send a "baud=" command at the current rate, and wait until it has been sent 
+ * and Nextion has changed rate. 
+ */
+static void nexSendBaud(uint32_t current, uint32_t baud)
+{
+    char cmd[16] = "baud=";
+    char digits[10];
+    uint8_t n = 0;
+    uint8_t len = 5;
+
+    do
+    {
+        digits[n++] = '0' + baud % 10;
+        baud /= 10;
+    } while (baud != 0);
+    while (n != 0)
+    {
+        cmd[len++] = digits[--n];
+    }
+    cmd[len] = 0;
+
+    nexSerial.begin(current);
+    sendCommand("");                                    /* ends any partial command */
+    sendCommand(cmd);
+    while (__tx_tail != __tx_head)
+    {
+        nexTxService();
+    }
+    nexSerial.flush();
+    delay(NEX_BAUD_SETTLE_MS);
+}
+
+
+uint32_t nexChangeBaud(uint32_t current, uint32_t baud)
+{
+    uint8_t i;
+
+    nexSendBaud(current, baud);
+    for (i = 0; i < NEX_BAUD_CHECKS; i++)
+    {
+        if (!nexProbe(baud))
+        {
+            break;
+        }
+    }
+    if (i == NEX_BAUD_CHECKS)
+    {
+        return baud;
+    }
+    if (nexProbe(current))
+    {
+        return current;                                 /* rate not accepted */
+    }
+    for (i = 0; i < NEX_BAUD_RETRIES; i++)              /* accepted, but the link has errors at the new rate */
+    {
+        nexSendBaud(baud, current);
+        if (nexProbe(current))
+        {
+            return current;
+        }
+    }
+    return 0;
+}
+
+
 bool nexInit(long Speed)
 {
-    bool ret1 = false;
-    bool ret2 = false;
-    
     dbSerialBegin(9600);
-    nexSerial.begin(Speed);
-    sendCommand("");
-    sendCommand("bkcmd=1");
-    ret1 = recvRetCommandFinished();
+    if (!nexProbe(Speed))
+    {
+        return false;
+    }
     sendCommand("page 0");
-    ret2 = recvRetCommandFinished();
-    return ret1 && ret2;
+    return recvRetCommandFinished();
 }
 
 void nexLoop(NexTouch *nex_listen_list[])
 {
-    static uint8_t __buffer[10];
-    
-    uint16_t i;
-    uint8_t c;  
-    
-    while (nexSerial.available() > 0)
-    {   
-        delay(10);
-        c = nexSerial.read();
-        
-        if (NEX_RET_EVENT_TOUCH_HEAD == c)
+    NexEvent *event;
+
+    nexPoll();
+    while (__event_tail != __event_head)
+    {
+        event = &__events[__event_tail++ & (NEX_EVENT_QUEUE_SIZE - 1)];
+        if (NEX_RET_EVENT_TOUCH_HEAD == event->head)
         {
-            if (nexSerial.available() >= 6)
-            {
-                __buffer[0] = c;  
-                for (i = 1; i < 7; i++)
-                {
-                    __buffer[i] = nexSerial.read();
-                }
-                __buffer[i] = 0x00;
-                
-                if (0xFF == __buffer[4] && 0xFF == __buffer[5] && 0xFF == __buffer[6])
-                {
-                    NexTouch::iterate(nex_listen_list, __buffer[1], __buffer[2], (int32_t)__buffer[3]);
-                }
-                
-            }
+            NexTouch::iterate(nex_listen_list, event->pid, event->cid, (int32_t)event->event);
         }
     }
 }
-
@@ -30,6 +30,27 @@
  */
 bool nexInit(long Speed = 9600);
 
+/**
+ * Check for Nextion at one baud rate: the serial port is set to the rate, and 
+ * a command must be acknowledged. Sets bkcmd=3 (every command returns a code). 
+ * 
+ * @return true if Nextion answered. 
+ */
+bool nexProbe(uint32_t baud);
+
+/**
+ * Move the link to a new baud rate with the "baud=" command, and check it with 
+ * several round trips. If they don't all work, the link is returned to the 
+ * current rate. The rate is not saved in Nextion: it uses its own rate 
+ * again after power on. 
+ * 
+ * @param current - rate in use. 
+ * @param baud - new rate. 
+ * @return the rate in use: baud if it works, current if not; 0 if Nextion is 
+ *  not answering at either rate. 
+ */
+uint32_t nexChangeBaud(uint32_t current, uint32_t baud);
+
 /**
  * Listen touch event and calling callbacks attached before.
  * 
@@ -43,6 +64,16 @@ bool nexInit(long Speed = 9600);
  */
 void nexLoop(NexTouch *nex_listen_list[]);
 
+/**
+ * Service the Nextion link: send queued command bytes, and decode bytes received, 
+ * queueing touch events for nexLoop. 
+ * 
+ * Never waits; called by nexLoop and when each command is sent, so events 
+ * that arrive while a command is in progress are not lost. Call it as often 
+ * as possible (eg from the main loop) to keep queued commands moving. 
+ */
+void nexPoll(void);
+
 /**
  * @}
  */
@@ -52,4 +83,29 @@ uint16_t recvRetString(char *buffer, uint16_t len, uint32_t timeout = 100);
 void sendCommand(const char* cmd);
 bool recvRetCommandFinished(uint32_t timeout = 100);
 
+/**
+ * Add a command to the batch sent by nexBatchFlush. 
+ * 
+ * An attribute assignment (eg "p2t2.txt=\"100\"") replaces an earlier assignment 
+ * to the same attribute in the batch; other commands are sent in order. No 
+ * acknowledgement is waited for: the return codes are dropped as they arrive. 
+ * 
+ * @return the most bytes the command can add to the link, including the 
+ *  terminating 0xFF bytes; 0 if it is an assignment of the value already displayed. 
+ */
+uint8_t nexBatchCommand(const char* cmd);
+
+/**
+ * Send the batch as one burst. Every attribute written is mirrored in RAM, and 
+ * an assignment of the value already displayed is dropped, so only the 
+ * differences are sent. 
+ */
+void nexBatchFlush(void);
+
+/**
+ * Forget the mirrored values: call when the display has changed page, so its 
+ * components are back to their initial values. 
+ */
+void nexInvalidateMirror(void);
+
 #endif /* #ifndef __NEXHARDWARE_H__ */
@@ -22,6 +22,8 @@
 #include <Arduino.h>
 #include <Nextion.h>
 #include "protect.h"
+#include "consttable.h"
+#include "formatter.h"
 
 
 //
@@ -49,6 +51,8 @@
 #define VXNEEDLEREVX1 35                      // X needle start position (px)
 #define VFIVESECONDS 312                      // at 16ms tick
 #define VVSWRFULLSCALE 10.0F                  // full scale VSWR indication
+#define VRXFRAMETICKS 16                      // ticks per meter page frame on receive (256ms)
+#define VNEEDLEKEEPALIVE 50                   // frames before the crossed needle is redrawn with no change
 //
 // global variables
 //
@@ -56,14 +60,21 @@ bool GNexDisplayPresent;                      // set to true if a display detect
 bool GIsPeakDisplay;                          // true if we are using peak display
 EDisplayPage GDisplayPage;                    // global set to current display page number
 int GSplashCountdown;                         // counter for splash page
-byte GUpdateItem;                             // display item being updated
+byte GUpdateItem;                             // crossed needle redraw step
 byte GCrossedNeedleItem;                      // display item in crossed needle page
 int GDisplayedForward, GDisplayedReverse;     // displayed meter angle values, to find if needle has moved
 int GReqdAngleForward, GReqdAngleReverse;     // required angles for crossed needle
 byte GForwardOverscale, GReverseOverscale;    // set non zero if an overscale detected. =no. ticks to display for
 bool GInitialisePage;                         // true if page needs to be initialised
 bool GCrossedNeedleRedrawing;                 // true if display is being redrawn
-unsigned char GUpdateMeterTicks;              // number of ticks since a meter display updated
+unsigned char GUpdateMeterTicks;              // number of frames since a meter display updated
+bool GDisplayTransmit;                        // true if the meter pages are running at the transmit rate
+unsigned int GDisplayBytes;                   // serial bytes batched for the display's next burst
+unsigned int GDisplayByteBudget;              // serial bytes allowed per frame at the link baud rate
+unsigned int GDisplayFrame;                   // display scheduler frame count
+EDisplayPage GScheduledPage;                  // page the display scheduler deadlines were set for
+const char* GScheduledStatus;                 // status string when the status widgets were last made due
+byte GFrameTicks;                             // ticks since the last meter page frame on receive
 
 // amp protection mode
 byte GBandDisplayed;                          // 0-7; 0 = 6m
@@ -75,21 +86,6 @@ bool IsCoarse;
 bool GTuneChanged;              // true if a tune operation has happened and display to be updated
 byte GVoltDisplayCount;
 
-//
-// display updates, for engineering display
-//
-unsigned int GDisplayItem;      // item to display at next tick
-byte GDisplayedL;               // value of L posted to display, to check for updates
-byte GDisplayedC;               // value of C posted to display, to check for updates
-int GDisplayedVSWR;             // VSWR value displayed
-int GDisplayedPower;            // power value displayed
-int GDisplayedVf;               // forward voltage displayed
-int GDisplayedVr;               // reverse voltage displayed
-bool GDisplayedPTT;             // PTT value displayed
-bool GDisplayedQuick;           // Quick tune value displayed
-bool GDisplayedTune;            // tune state displayed
-bool GDisplayedZ;               // true if High Z
-int GDisplayedFreq;             // frequency displayed
 byte GDisplayScale;             // scale in use (0-4)
 NoClickEncoder Encoder1(VPINENCODER1B, VPINENCODER1A, VENCODERDIVISOR, true);
 PushbuttonDebounce EncoderBtnDebounce(VPINENCODER1PB, 64);          // toggle L/C; longpress to toggle coarse/fine
@@ -273,7 +269,7 @@ NexButton p5Ant3Btn = NexButton(5, 9, "p5b4");              // Ant 3 erase pushb
 NexButton p5Ant4Btn = NexButton(5, 10, "p5b5");             // Ant 4 erase pushbutton
 NexButton p5ScaleBtn = NexButton(5, 4, "p5b1");             // change display scale pushbutton
 NexButton p5RtnBtn = NexButton(5, 1, "p5b0");               // return display pushbutton
-NexButton p5AlgBtn = NexButton(5, 12, "p5b6");              // algorithm "quick" pushbutton
+NexButton p5AlgBtn = NexButton(5, 12, "p5b6");              // algorithm strategy and "quick" pushbutton
 
 //
 // page 6 objects:
@@ -430,6 +426,47 @@ int GetVSWRPercent(void)
 
 //////////////////////////////////////////////////////////////////////////////////////
 
+//
+// add a command to the Nextion command batch, counting the serial bytes it will take
+//
+void BatchCommand(const char* Command)
+{
+  GDisplayBytes += nexBatchCommand(Command);
+}
+
+
+//
+// add a text or number attribute write to the Nextion command batch
+// the batch is sent once per display tick; a write of the value already displayed is dropped
+// Attribute is the control name and attribute, eg "p2t2.txt"
+//
+void BatchText(const char* Attribute, const char* Text)
+{
+  char Str[40];
+  SFormatter Fmt;
+
+  FormatBegin(&Fmt, Str, sizeof(Str));
+  FormatLiteral(&Fmt, Attribute);
+  FormatLiteral(&Fmt, "=\"");
+  FormatLiteral(&Fmt, Text);
+  FormatChar(&Fmt, '"');
+  BatchCommand(Str);
+}
+
+
+void BatchValue(const char* Attribute, int Value)
+{
+  char Str[40];
+  SFormatter Fmt;
+
+  FormatBegin(&Fmt, Str, sizeof(Str));
+  FormatLiteral(&Fmt, Attribute);
+  FormatChar(&Fmt, '=');
+  FormatInt(&Fmt, Value);
+  BatchCommand(Str);
+}
+
+
 //
 // set "high/low Z" button text
 //
@@ -438,9 +475,9 @@ void SetHighLowZButtonText()
   if((GDisplayPage == eEngineeringPage) && GNexDisplayPresent)
   {
     if(GetHiLoZ())
-      p4HighZBtn.setText("High Z");
+      BatchText("p4b6.txt", "High Z");                          // p4HighZBtn
     else
-      p4HighZBtn.setText("Low Z");
+      BatchText("p4b6.txt", "Low Z");
   }
 
 }
@@ -454,9 +491,9 @@ void SetCoarseButtonText()
   if((GDisplayPage == eEngineeringPage) && GNexDisplayPresent)
   {
     if(IsCoarse)
-      p4FineBtn.setText("Coarse");
+      BatchText("p4b5.txt", "Coarse");                          // p4FineBtn
     else
-      p4FineBtn.setText("Fine");
+      BatchText("p4b5.txt", "Fine");
   }
 }
 
@@ -467,33 +504,33 @@ void SetCoarseButtonText()
 //
 void SetEnabledButtonText()
 {
-  NexButton* Ptr;
+  const char* Attribute;
 
-  switch(GDisplayPage)                              // get ptr to the right page's control
+  switch(GDisplayPage)                              // get the right page's control
   {
-    case eSplashPage:                              // startup splash page
-      Ptr = NULL;
+    default:                                        // startup splash page etc
+      Attribute = NULL;
       break;
     case eCrossedNeedlePage:                       // crossed needle VSWR page display
-      Ptr = &p1EnableBtn;
+      Attribute = "p1b2.txt";                      // p1EnableBtn
       break;
     case ePowerBargraphPage:                        // linear watts bargraph page display
-      Ptr = &p2EnableBtn;
+      Attribute = "p2b2.txt";                       // p2EnableBtn
       break;
     case eMeterPage:                                // analogue power meter
-      Ptr = &p3EnableBtn;
+      Attribute = "p3b2.txt";                       // p3EnableBtn
       break;
     case eEngineeringPage:                          // engineering page with raw ADC values
-      Ptr = &p4EnableBtn;
+      Attribute = "p4b7.txt";                       // p4EnableBtn
       break;
   }
 
-  if ((Ptr != NULL) && GNexDisplayPresent)          // if there is a valid control, update it
+  if ((Attribute != NULL) && GNexDisplayPresent)    // if there is a valid control, update it
   {
     if(GATUEnabled)
-      Ptr->setText("Enabled");
+      BatchText(Attribute, "Enabled");
     else
-      Ptr->setText("Disabled");
+      BatchText(Attribute, "Disabled");
   }
 }
 
@@ -506,30 +543,29 @@ void SetEnabledButtonText()
 //
 void SetPeakButtonText()
 {
-  NexButton* Ptr;
+  const char* Attribute;
 
-  switch(GDisplayPage)                              // get ptr to the right page's control
+  switch(GDisplayPage)                              // get the right page's control
   {
-    case eSplashPage:                               // startup splash page
-    case eEngineeringPage:                          // engineering page with raw ADC values
-      Ptr = NULL;
+    default:                                        // startup splash page, engineering page etc
+      Attribute = NULL;
       break;
     case eCrossedNeedlePage:                        // crossed needle VSWR page display
-      Ptr = &p1PeakBtn;
+      Attribute = "p1b1.txt";                       // p1PeakBtn
       break;
     case ePowerBargraphPage:                        // linear watts bargraph page display
-      Ptr = &p2PeakBtn;
+      Attribute = "p2b1.txt";                       // p2PeakBtn
       break;
     case eMeterPage:                                // analogue power meter
-      Ptr = &p3PeakBtn;
+      Attribute = "p3b1.txt";                       // p3PeakBtn
       break;
   }
-  if ((Ptr != NULL) && GNexDisplayPresent)          // if there is a valid control, update it
+  if ((Attribute != NULL) && GNexDisplayPresent)    // if there is a valid control, update it
   {
     if(GIsPeakDisplay)
-      Ptr->setText("Peak");
+      BatchText(Attribute, "Peak");
     else
-      Ptr->setText("Average");
+      BatchText(Attribute, "Average");
   }
 }
 
@@ -542,36 +578,48 @@ void SetPeakButtonText()
 //
 void page1PushCallback(void *ptr)             // called when page 1 loads (x needle)
 {
+  nexInvalidateMirror();                     // new page: its controls are back to initial values
+  GScheduledPage = eTransitioning;           // and all its widgets are due
   GDisplayPage = eCrossedNeedlePage;
   GInitialisePage = true;
 }
 
 void page2PushCallback(void *ptr)             // called when page 2 loads (log bargraph)
 {
+  nexInvalidateMirror();                     // new page: its controls are back to initial values
+  GScheduledPage = eTransitioning;           // and all its widgets are due
   GDisplayPage = ePowerBargraphPage;
   GInitialisePage = true;
 }
 
 void page3PushCallback(void *ptr)             // called when page 3 loads (analogue meter)
 {
+  nexInvalidateMirror();                     // new page: its controls are back to initial values
+  GScheduledPage = eTransitioning;           // and all its widgets are due
   GDisplayPage = eMeterPage;
   GInitialisePage = true;
 }
 
 void page4PushCallback(void *ptr)             // called when page 4 loads (engineering)
 {
+  nexInvalidateMirror();                     // new page: its controls are back to initial values
+  GScheduledPage = eTransitioning;           // and all its widgets are due
   GDisplayPage = eEngineeringPage;
   GInitialisePage = true;
 }
 
 void page5PushCallback(void *ptr)             // called when page 5 loads (setup)
 {
+  nexInvalidateMirror();                     // new page: its controls are back to initial values
+  GScheduledPage = eTransitioning;           // and all its widgets are due
   GDisplayPage = eSetupPage;
   GInitialisePage = true;
 }
 
 void page6PushCallback(void *ptr)             // called when page 6 loads (trip)
 {
+  nexInvalidateMirror();                     // new page: its controls are back to initial values
+  GScheduledPage = eTransitioning;           // and all its widgets are due
   GDisplayPage = eTripPage;
   GInitialisePage = true;
 }
@@ -824,9 +872,10 @@ void p4HighZPushCallback(void *ptr)           // get new High/Low Z state
 //
 void p5Ant1PushCallback(void *ptr)         // erase antenna 1
 {
-  p5EraseTxt.setText("Erasing");
+  BatchText("p5t0.txt", "Erasing");                            // p5EraseTxt
+  nexBatchFlush();                                              // show it before the erase
   EEEraseSolutionSet(1);
-  p5EraseTxt.setText("Done");
+  BatchText("p5t0.txt", "Done");
 }
 
 
@@ -835,9 +884,10 @@ void p5Ant1PushCallback(void *ptr)         // erase antenna 1
 //
 void p5Ant2PushCallback(void *ptr)         // erase antenna 2
 {
-  p5EraseTxt.setText("Erasing");
+  BatchText("p5t0.txt", "Erasing");                            // p5EraseTxt
+  nexBatchFlush();                                              // show it before the erase
   EEEraseSolutionSet(2);
-  p5EraseTxt.setText("Done");
+  BatchText("p5t0.txt", "Done");
 }
 
 
@@ -846,9 +896,10 @@ void p5Ant2PushCallback(void *ptr)         // erase antenna 2
 //
 void p5Ant3PushCallback(void *ptr)         // erase antenna 3
 {
-  p5EraseTxt.setText("Erasing");
+  BatchText("p5t0.txt", "Erasing");                            // p5EraseTxt
+  nexBatchFlush();                                              // show it before the erase
   EEEraseSolutionSet(3);
-  p5EraseTxt.setText("Done");
+  BatchText("p5t0.txt", "Done");
 }
 
 
@@ -857,9 +908,10 @@ void p5Ant3PushCallback(void *ptr)         // erase antenna 3
 //
 void p5Ant4PushCallback(void *ptr)         // erase antenna 4
 {
-  p5EraseTxt.setText("Erasing");
+  BatchText("p5t0.txt", "Erasing");                            // p5EraseTxt
+  nexBatchFlush();                                              // show it before the erase
   EEEraseSolutionSet(4);
-  p5EraseTxt.setText("Done");
+  BatchText("p5t0.txt", "Done");
 }
 
 
@@ -871,7 +923,7 @@ void p5ScalePushCallback(void *ptr)         // set display scale
   if(++GDisplayScale > VDISPLAYSCALE)         // increment, save to eeprom then display
     GDisplayScale = 0;
   EEWriteScale(GDisplayScale);
-  p5ScaleTxt.setText(GDisplayScaleStrings[GDisplayScale]);
+  BatchText("p5t1.txt", GDisplayScaleStrings[GDisplayScale]);  // p5ScaleTxt
 }
 
 
@@ -888,16 +940,37 @@ void p5RtnPushCallback(void *ptr)           // change display
 
 
 //
-// touch event - page 5 Algorithm quick/not quick
+// show the algorithm setting on page 5 button: strategy name then quick/full
+//
+void DisplayAlgorithmSetting(void)
+{
+  char Str[20];
+  SFormatter Fmt;
+
+  FormatBegin(&Fmt, Str, sizeof(Str));
+  FormatLiteral(&Fmt, GetTuneStrategyName(GTuneStrategy));
+  if(GQuickTuneEnabled)
+    FormatLiteral(&Fmt, " Quick");
+  else
+    FormatLiteral(&Fmt, " Full");
+  BatchText("p5b6.txt", Str);                                  // p5AlgBtn
+}
+
+
+//
+// touch event - page 5 Algorithm
+// steps quick then full for each tuning strategy in turn
 //
 void p5AlgPushCallback(void *ptr)           // change algorithm setting
 {
   GQuickTuneEnabled = !GQuickTuneEnabled;
+  if(GQuickTuneEnabled)                     // wrapped round to quick: move on to next strategy
+  {
+    SetTuneStrategy(GTuneStrategy + 1);
+    EEWriteStrategy(GTuneStrategy);
+  }
   EEWriteQuick(GQuickTuneEnabled);
-  if(GQuickTuneEnabled)
-    p5AlgBtn.setText("Quick");
-  else
-    p5AlgBtn.setText("Full");
+  DisplayAlgorithmSetting();
 }
 
 
@@ -915,127 +988,114 @@ void p6ResetPushCallback(void *ptr)           // reset protection
 ///////////////////////////////////////////////////////////////////////////////////////////
 
 
-#define VASCII0 0x30                // zero character in ASCII
 //
-// local version of "sprintf like" function
-// Adds a decimal point before last digit if 3rd parameter set
-// note integer value is signed and may be negative!
+// set foreground and background of bargraphs to set power scale
 //
-unsigned char mysprintf(char *dest, int Value, bool AddDP)
+void SetBargraphImages(void)
 {
-  unsigned char Digit;              // calculated digit
-  bool HadADigit = false;           // true when found a non zero digit
-  unsigned char DigitCount = 0;     // number of returned digits
-  unsigned int Divisor = 10000;     // power of 10 being calculated
-//
-// deal with negative values first
-//
-  if (Value < 0)
-  {
-    *dest++ = '-';    // add to output
-    DigitCount++;
-    Value = -Value;
-  }
-//
-// now convert the (definitely posirive) number
-//
-  while (Divisor >= 10)
+  if((GDisplayPage == 2) && GNexDisplayPresent)
   {
-    Digit = Value / Divisor;        // find digit: integer divide
-    if (Digit != 0)
-      HadADigit = true;             // flag if non zero so all trailing digits added
-    if (HadADigit)                  // if 1st non zero or all subsequent
-    {
-      *dest++ = Digit + VASCII0;    // add to output
-      DigitCount++;
-    }
-    Value -= (Digit * Divisor);     // get remainder from divide
-    Divisor = Divisor / 10;         // ready for next digit
+    BatchValue("p2j0.ppic", GPowerForeground[GDisplayScale]);     // foreground image number
+    BatchValue("p2j0.bpic", GPowerBackground[GDisplayScale]);     // background image number
   }
+}
+
+
 //
-// if we need a decimal point, add it now. Also if there hasn't been a preceiding digit
-// (i.e. number was like 0.3) add the zero
+// set background for meter display to set the power scale
 //
-  if (AddDP)
-  {
-    if (HadADigit == false)
-    {
-      *dest++ = '0';
-      DigitCount++;
-    }
-    *dest++ = '.';
-  DigitCount++;
-  }
-  *dest++ = Value + VASCII0;
-  DigitCount++;
+void SetMeterImages(void)
+{
+  if((GDisplayPage == 3) && GNexDisplayPresent)
+    BatchValue("p3z0.picc", GMeterPicture[GDisplayScale]);        // foreground image number
+}
+
+
+
 //
-// finally terminate with a 0
+// set background for crossed needle display to set the power scale
 //
-  *dest++ = 0;
-
-  return DigitCount;
+void SetCrossedNeedleImages(void)
+{
+  if((GDisplayPage == 1) && GNexDisplayPresent)
+    BatchValue("p1p0.pic", GCrossedNeedlePicture[GDisplayScale]);  // p1Axes foreground image number
 }
 
 
+
 //
-// set foreground and background of bargraphs to set power scale
+// display link baud rate
+// the display starts at the rate set in its HMI file (115200). The "baud=" command isn't
+// saved in the display, so at each power on it is moved to the fastest rate in the table
+// that passes its round trip checks. That rate is saved in EEPROM and tried first at the
+// next boot, so after a processor reset (display still at that rate) it connects at once.
+// a rate that fails doesn't limit later boots: they try from the fastest again.
+// the serial byte budget per frame scales with the rate.
 //
-void SetBargraphImages(void)
-{
-  byte Image;
-  char Str[20];
-  char Str2[5];
+#define VNUMDISPLAYBAUDS 6
+#define VPOWERONBAUD 4                        // index of the HMI file's rate
+#define VDISPLAYBYTEBUDGET 72                 // serial bytes per frame at 115200 baud (which carries 184 per 16ms tick)
+#define VMINBYTEBUDGET 40                     // longest single command
+#define VMAXBYTEBUDGET 240                    // Nextion library transmit buffer is 256 bytes
 
-  Str2[0]=0;                                            // empty the string
-  if((GDisplayPage == 2) && GNexDisplayPresent)
-  {
-    Image = GPowerForeground[GDisplayScale];       // foreground image number
-    mysprintf(Str2, Image, false);
-    strcpy(Str,"p2j0.ppic=");
-    strcat(Str, Str2);
-    sendCommand(Str);
-    Image = GPowerBackground[GDisplayScale];       // background image number
-    mysprintf(Str2, Image, false);
-    strcpy(Str,"p2j0.bpic=");
-    strcat(Str, Str2);
-    sendCommand(Str);
-  }
-}
+const uint32_t GDisplayBauds[VNUMDISPLAYBAUDS] = {921600, 512000, 256000, 230400, 115200, 9600};
 
 
 //
-// set background for meter display to set the power scale
+// find the rate the display is using: its own rate first, then the rest
+// return true if found, with its table index in *Index
 //
-void SetMeterImages(void)
+bool FindDisplayBaud(byte* Index)
 {
-  byte Image;
-  char Str[20];
-  char Str2[5];
+  byte Cntr;
 
-  Str2[0]=0;                                            // empty the string
-  if((GDisplayPage == 3) && GNexDisplayPresent)
+  for(Cntr = 0; Cntr < VNUMDISPLAYBAUDS; Cntr++)
   {
-    Image = GMeterPicture[GDisplayScale];       // foreground image number
-    mysprintf(Str2, Image, false);
-    strcpy(Str,"p3z0.picc=");
-    strcat(Str, Str2);
-    sendCommand(Str);
+    *Index = (VPOWERONBAUD + Cntr) % VNUMDISPLAYBAUDS;
+    if(nexProbe(GDisplayBauds[*Index]))
+      return true;
   }
+  return false;
 }
 
 
-
 //
-// set background for crossed needle display to set the power scale
+// connect to the display and set the fastest link rate
+// return true if display found
 //
-void SetCrossedNeedleImages(void)
+bool ConnectDisplay(void)
 {
-  byte Image;
-  if((GDisplayPage == 1) && GNexDisplayPresent)
+  byte Saved, Current, Index;
+  uint32_t Baud;
+
+  Saved = EEReadDisplayBaud();
+  if((Saved < VNUMDISPLAYBAUDS) && nexProbe(GDisplayBauds[Saved]))
+    Current = Saved;                          // still at the saved rate: processor reset
+  else
   {
-    Image = GCrossedNeedlePicture[GDisplayScale];       // foreground image number
-    p1Axes.setPic(Image);
+    if(!FindDisplayBaud(&Current))
+      return false;
+//
+// then move up to the fastest rate that works
+//
+    for(Index = 0; Index < Current; Index++)
+    {
+      Baud = nexChangeBaud(GDisplayBauds[Current], GDisplayBauds[Index]);
+      if(Baud == GDisplayBauds[Index])
+      {
+        Current = Index;
+        break;
+      }
+      if((Baud == 0) && !FindDisplayBaud(&Current))
+        return false;                         // lost the display, and not found at any rate
+    }
   }
+  if(Current != Saved)                        // (only a rate that has answered is saved)
+    EEWriteDisplayBaud(Current);
+
+  GDisplayByteBudget = constrain(VDISPLAYBYTEBUDGET * (GDisplayBauds[Current] / 9600) / 12, VMINBYTEBUDGET, VMAXBYTEBUDGET);
+  sendCommand("page 0");
+  return recvRetCommandFinished();
 }
 
 
@@ -1046,12 +1106,12 @@ void SetCrossedNeedleImages(void)
 void LCD_UI_Initialise(void)
 {
   char Str[10];
+  SFormatter Fmt;
 
   GDisplayScale = EEReadScale();                              // get display scale to use
   SetADCScaleFactor(GDisplayScale);
   
-  GDisplayItem = 0;
-  GNexDisplayPresent = nexInit(115200);
+  GNexDisplayPresent = ConnectDisplay();
 
   page1.attachPush(page1PushCallback);
   page2.attachPush(page2PushCallback);
@@ -1087,22 +1147,13 @@ void LCD_UI_Initialise(void)
   p6ResetBtn.attachPush(p6ResetPushCallback);
 //
 // initialise display variables, then set all elements
+// (the display library mirrors the values shown, and only sends changes)
 //  
-  GDisplayedL = 0;               // value of L posted to display, to check for updates
-  GDisplayedC = 0;               // value of C posted to display, to check for updates
-  GDisplayedVSWR = 10;           // VSWR value displayed
-  GDisplayedPower = 0;           // power value displayed
-  GDisplayedVf = 0;              // forward voltage displayed
-  GDisplayedVr = 0;              // reverse voltage displayed
-  GDisplayedPTT = false;         // PTT value displayed
-  GDisplayedTune = false;        // tune state displayed
-  GDisplayedFreq = 0;              // frequency displayed
-  GDisplayedZ = false;
-
   GIsPeakDisplay = EEReadPeak();
-  mysprintf(Str, SWVERSION, false);                 // set s/w version on splash page
+  FormatBegin(&Fmt, Str, sizeof(Str));
+  FormatInt(&Fmt, SWVERSION);                       // set s/w version on splash page
   if(GNexDisplayPresent)
-    p0SWVersion.setText(Str);
+    BatchText("p0t4.txt", Str);                     // p0SWVersion
   GSplashCountdown = VFIVESECONDS;                  // ticks to stay in splash page
   GUpdateItem = 0;
 }
@@ -1118,37 +1169,45 @@ void SetTuneChanged()
 
 
 //
-// set status string, for all display pages
+// get ATU status string, for all display pages
 //
-void SetStatusString(void)
+const char* GetStatusString(void)
 {
-  char StatusString[20];                       // ATU status string
-  
   if(!GATUEnabled)
-    strcpy(StatusString, "Disabled");
+    return "Disabled";
   else if (GTuneActive)
-    strcpy(StatusString, "Tuning");
+    return "Tuning";
   else if (GValidSolution)
-    strcpy(StatusString, "ATU Tuned");
+    return "ATU Tuned";
   else
-    strcpy(StatusString, "No Tune");
+    return "No Tune";
+}
+
 
+//
+// set status string, for all display pages
+//
+void SetStatusString(void)
+{
+  const char* StatusString;                    // ATU status string
+  
+  StatusString = GetStatusString();
   if(GNexDisplayPresent)
     switch(GDisplayPage)
     {
       case eSplashPage:                              // startup splash page
         break;
       case eCrossedNeedlePage:                       // crossed needle VSWR page display
-        p1Status.setText(StatusString);
+        BatchText("p1t0.txt", StatusString);         // p1Status
         break;
       case ePowerBargraphPage:                       // linear watts bargraph page display
-        p2Status.setText(StatusString);
+        BatchText("p2t0.txt", StatusString);         // p2Status
         break;
       case eMeterPage:                               // analogue power meter
-        p3Status.setText(StatusString);
+        BatchText("p3t0.txt", StatusString);         // p3Status
         break;
       case eEngineeringPage:                          // engineering page with raw ADC values
-        p4Status.setText(StatusString);
+        BatchText("p4t0.txt", StatusString);         // p4Status
         break;
     }
 }
@@ -1164,26 +1223,427 @@ void LCD_UI_EncoderTick(bool OddEncoder)
 
 
 
+//
+// crossed needle end points, for every integer angle from VMINXNEEDLEANGLE to 90 degrees
+// calculated by the compiler, so drawing a needle needs no floating point.
+// sine and cosine are by series (angle in radians, 0 to pi/2; X2 = angle squared)
+//
+#define VMINNEEDLETABLEANGLE ((int)VMINXNEEDLEANGLE)      // first angle in table
+#define VNUMNEEDLEANGLES (91 - VMINNEEDLETABLEANGLE)      // table runs to 90 degrees
+
+struct SNeedleEnd
+{
+  int16_t FwdX2;                                          // forward needle X end position (px)
+  int16_t RevX2;                                          // reverse needle X end position (px)
+  int16_t Y2;                                             // Y end position, both needles (px)
+};
+
+constexpr double SeriesSin(double X, double X2)
+{
+  return X * (1 - X2/6 * (1 - X2/20 * (1 - X2/42 * (1 - X2/72 * (1 - X2/110 * (1 - X2/156))))));
+}
+
+constexpr double SeriesCos(double X2)
+{
+  return 1 - X2/2 * (1 - X2/12 * (1 - X2/30 * (1 - X2/56 * (1 - X2/90 * (1 - X2/132 * (1 - X2/182))))));
+}
+
+static_assert((SeriesSin(M_PI/2, M_PI*M_PI/4) > 0.999999) && (SeriesCos(M_PI*M_PI/4) < 0.000001), "needle table series not accurate enough");
+
+constexpr int16_t RoundToPixel(double Value)
+{
+  return (int16_t)(Value + 0.5);
+}
+
+constexpr SNeedleEnd MakeNeedleEnd(double Angle)
+{
+  return SNeedleEnd{RoundToPixel(VXNEEDLEFWDX1 - VNEEDLESIZE * SeriesCos(Angle * Angle)),
+                    RoundToPixel(VXNEEDLEREVX1 + VNEEDLESIZE * SeriesCos(Angle * Angle)),
+                    RoundToPixel(VXNEEDLEY1 - VNEEDLESIZE * SeriesSin(Angle, Angle * Angle))};
+}
+
+template<unsigned int... I> constexpr STableOf<SNeedleEnd, sizeof...(I)> MakeNeedleTable(SIndexList<I...>)
+{
+  return STableOf<SNeedleEnd, sizeof...(I)>{{MakeNeedleEnd((I + VMINNEEDLETABLEANGLE) * M_PI / 180.0)...}};
+}
+
+const STableOf<SNeedleEnd, VNUMNEEDLEANGLES> GNeedleTable = MakeNeedleTable(SMakeIndexList<VNUMNEEDLEANGLES>::Type());
+
+
+
+//
+// display frame rate governor: returns true if the meter pages should update this tick
+// on transmit (PTT pressed, or tuning) that is every tick; on receive there is nothing
+// moving, so the pages get a trickle refresh, leaving serial and CPU time for CAT and EEPROM.
+// the first tick back on receive is a frame, so the meters show the power has gone.
+//
+bool DisplayFrameDue(void)
+{
+  bool Transmit;
+  bool Due = false;
+
+  Transmit = GPTTPressed || GTuneActive;
+  if(Transmit || GDisplayTransmit)
+  {
+    Due = true;
+    GFrameTicks = 0;
+  }
+  else if(++GFrameTicks >= VRXFRAMETICKS)
+  {
+    Due = true;
+    GFrameTicks = 0;
+  }
+  GDisplayTransmit = Transmit;
+  return Due;
+}
+
+
+
+//
+// add a crossed needle line to the Nextion command batch
+// the angle is measured from horizontal, away from the other needle
+//
+void BatchNeedleLine(int Degrees, bool IsForward)
+{
+  char Str[40];
+  SFormatter Fmt;
+  const SNeedleEnd* End;
+  int X1, X2;
+
+  Degrees = constrain(Degrees, VMINNEEDLETABLEANGLE, 90);
+  End = GNeedleTable.Rows + (Degrees - VMINNEEDLETABLEANGLE);
+  if(IsForward)
+  {
+    X1 = VXNEEDLEFWDX1;
+    X2 = End -> FwdX2;
+  }
+  else
+  {
+    X1 = VXNEEDLEREVX1;
+    X2 = End -> RevX2;
+  }
+// get text commands
+  FormatBegin(&Fmt, Str, sizeof(Str));
+  FormatLiteral(&Fmt, "line ");     // line
+  FormatInt(&Fmt, X1);
+  FormatChar(&Fmt, ',');            // line X1,
+  FormatInt(&Fmt, VXNEEDLEY1);
+  FormatChar(&Fmt, ',');            // line X1,Y1,
+  FormatInt(&Fmt, X2);
+  FormatChar(&Fmt, ',');            // line X1,Y1,X2
+  FormatInt(&Fmt, End -> Y2);
+  FormatLiteral(&Fmt, ",BLUE");     // line X1,Y1,X2,Y2,BLUE
+  BatchCommand(Str);
+}
+
+
+
+//
+// display scheduler
+// every control refreshed periodically is listed in GDisplayWidgets, with its page, refresh
+// period, priority and value source. Each frame the widgets on the current page that are due
+// are sent, highest priority first then most overdue first, until the frame's serial byte
+// budget is used; a widget that doesn't fit stays due, and goes first next frame.
+// the high priority widgets on any page fit well within the budget, so they are always
+// refreshed in their period; the rest fill the remaining capacity.
+// on the meter pages a frame is set by the governor; the other pages have a frame every tick.
+// the status widgets have a long period, so they are made due at once when the status changes.
+// to add a control, add a source function and a table entry - there is no sequence to re-time.
+//
+#define VPRIORITYLOW 0                        // widget priorities
+#define VPRIORITYMEDIUM 1
+#define VPRIORITYHIGH 2
+
+
+struct SDisplayWidget
+{
+  EDisplayPage Page;                          // page the control is on
+  const char* Attribute;                      // control name and attribute, eg "p2t2.txt"
+  bool IsText;                                // true if a text attribute (value sent in quotes)
+  byte Period;                                // refresh period, frames
+  byte Priority;                              // VPRIORITYLOW to VPRIORITYHIGH
+  void (*Source)(SFormatter* Fmt, byte Param);  // appends the value to display
+  byte Param;                                 // passed to the source
+};
+
+
+//
+// value sources
+//
+void StatusSource(SFormatter* Fmt, byte Param)
+{
+  FormatLiteral(Fmt, GetStatusString());
+}
+
+
+void ForwardPercentSource(SFormatter* Fmt, byte Param)
+{
+  FormatInt(Fmt, GetPowerPercent(true, GIsPeakDisplay));
+}
+
+
+void VSWRPercentSource(SFormatter* Fmt, byte Param)
+{
+  FormatInt(Fmt, GetVSWRPercent());
+}
+
+
+void MeterDegreesSource(SFormatter* Fmt, byte Param)
+{
+  FormatInt(Fmt, GetPowerMeterDegrees(true, GIsPeakDisplay));
+}
+
+
+void ForwardPowerSource(SFormatter* Fmt, byte Param)
+{
+  if(GIsPeakDisplay)
+    FormatInt(Fmt, FindPeakPower(true));              // forward peak power, in watts
+  else
+    FormatInt(Fmt, GetPowerReading(true));            // forward power, in watts
+}
+
+
+//
+// VSWR to 1dp; Param=1 to show "---" if there is no power
+//
+void VSWRSource(SFormatter* Fmt, byte Param)
+{
+  if((Param != 0) && (GForwardPower == 0))
+    FormatLiteral(Fmt, "---");
+  else
+    FormatFixed(Fmt, (int)(GVSWR*10.0), 1);
+}
+
+
+void InductanceSource(SFormatter* Fmt, byte Param)
+{
+  FormatInt(Fmt, GetInductance());
+}
+
+
+void CapacitanceSource(SFormatter* Fmt, byte Param)
+{
+  FormatInt(Fmt, GetCapacitance());
+}
+
+
+void PowerSource(SFormatter* Fmt, byte Param)
+{
+  FormatInt(Fmt, GForwardPower);
+}
+
+
+//
+// ADC mean and peak; Param=1 for forward, 0 for reverse
+//
+void ADCSource(SFormatter* Fmt, byte Param)
+{
+  unsigned int ADCMean, ADCPeak;
+
+  GetADCMeanAndPeak(Param != 0, &ADCMean, &ADCPeak);
+  FormatInt(Fmt, ADCMean);
+  FormatChar(Fmt, ' ');
+  FormatInt(Fmt, ADCPeak);
+}
+
+
+void PTTSource(SFormatter* Fmt, byte Param)
+{
+  if(GPTTPressed == true)
+    FormatLiteral(Fmt, "PTT");
+  else
+    FormatLiteral(Fmt, "no PTT");
+}
+
+
+void QuickSource(SFormatter* Fmt, byte Param)
+{
+  if(GQuickTuneEnabled == true)
+    FormatLiteral(Fmt, "Quick");
+  else
+    FormatLiteral(Fmt, "Full");
+}
+
+
+void HighLowZSource(SFormatter* Fmt, byte Param)
+{
+  if(GetHiLoZ())
+    FormatLiteral(Fmt, "High Z");
+  else
+    FormatLiteral(Fmt, "Low Z");
+}
+
+
+void CurrentSource(SFormatter* Fmt, byte Param)
+{
+  FormatFixed(Fmt, GPACurrent, 1);                    // 1dp
+}
+
+
+//
+// one protection trip input; Param = bit number
+//
+void TripSource(SFormatter* Fmt, byte Param)
+{
+  if(((GTripInputBits >> Param) & 0b1) == 0b1)       // if trip bit set
+    FormatLiteral(Fmt, "Tripped");
+  else
+    FormatLiteral(Fmt, "OK");
+}
+
+
+void TripResetSource(SFormatter* Fmt, byte Param)
+{
+  if(GTripInputBits == 0)
+    FormatLiteral(Fmt, "RESET");
+  else
+    FormatLiteral(Fmt, "tripped");
+}
+
+
+//
+// the widgets
+// high priority worst case bytes per page: p2 48; p3 30; p4 37 (all within the budget at 115200 baud and above)
+//
+const SDisplayWidget GDisplayWidgets[] =
+{
+  {eCrossedNeedlePage, "p1t0.txt", true, 15, VPRIORITYLOW, StatusSource, 0},           // p1Status
+
+  {ePowerBargraphPage, "p2j0.val", false, 1, VPRIORITYHIGH, ForwardPercentSource, 0},  // p2FwdBar
+  {ePowerBargraphPage, "p2j1.val", false, 1, VPRIORITYHIGH, VSWRPercentSource, 0},     // p2VSWRBar
+  {ePowerBargraphPage, "p2t2.txt", true, 8, VPRIORITYHIGH, ForwardPowerSource, 0},     // p2FwdPower
+  {ePowerBargraphPage, "p2t3.txt", true, 11, VPRIORITYMEDIUM, VSWRSource, 0},          // p2VSWRTxt
+  {ePowerBargraphPage, "p2t0.txt", true, 11, VPRIORITYLOW, StatusSource, 0},           // p2Status
+
+  {eMeterPage, "p3z0.val", false, 1, VPRIORITYHIGH, MeterDegreesSource, 0},            // p3Meter
+  {eMeterPage, "p3j0.val", false, 1, VPRIORITYHIGH, VSWRPercentSource, 0},             // p3VSWRBar
+  {eMeterPage, "p3t0.txt", true, 15, VPRIORITYLOW, StatusSource, 0},                   // p3Status
+
+  {eEngineeringPage, "p4t1.txt", true, 10, VPRIORITYMEDIUM, InductanceSource, 0},      // p4LValue
+  {eEngineeringPage, "p4t2.txt", true, 10, VPRIORITYMEDIUM, CapacitanceSource, 0},     // p4CValue
+  {eEngineeringPage, "p4t3.txt", true, 10, VPRIORITYHIGH, VSWRSource, 1},              // p4VSWRValue
+  {eEngineeringPage, "p4t4.txt", true, 10, VPRIORITYHIGH, PowerSource, 0},             // p4PowerValue
+  {eEngineeringPage, "p4t5.txt", true, 21, VPRIORITYLOW, ADCSource, 1},                // p4VfValue
+  {eEngineeringPage, "p4t6.txt", true, 21, VPRIORITYLOW, ADCSource, 0},                // p4VrValue
+  {eEngineeringPage, "p4t9.txt", true, 21, VPRIORITYLOW, PTTSource, 0},                // p4PTT
+  {eEngineeringPage, "p4t11.txt", true, 21, VPRIORITYLOW, QuickSource, 0},             // p4Quick
+  {eEngineeringPage, "p4t0.txt", true, 21, VPRIORITYLOW, StatusSource, 0},             // p4Status
+  {eEngineeringPage, "p4b6.txt", true, 21, VPRIORITYLOW, HighLowZSource, 0},           // p4HighZBtn
+  {eEngineeringPage, "p4t12.txt", true, 21, VPRIORITYLOW, CurrentSource, 0},           // p4Current
+
+  {eTripPage, "p6t5.txt", true, 13, VPRIORITYMEDIUM, TripSource, 0},                   // VSWR trip
+  {eTripPage, "p6t6.txt", true, 13, VPRIORITYMEDIUM, TripSource, 1},                   // reverse power trip
+  {eTripPage, "p6t7.txt", true, 13, VPRIORITYMEDIUM, TripSource, 2},                   // drive power trip
+  {eTripPage, "p6t8.txt", true, 13, VPRIORITYMEDIUM, TripSource, 3},                   // temperature trip
+  {eTripPage, "p6b0.txt", true, 13, VPRIORITYMEDIUM, TripResetSource, 0}               // p6ResetBtn
+};
+
+#define VNUMWIDGETS (sizeof(GDisplayWidgets) / sizeof(GDisplayWidgets[0]))
+static_assert(VNUMWIDGETS <= 32, "too many display widgets for the sent flags in RunDisplayScheduler");
+
+unsigned int GWidgetDue[VNUMWIDGETS];         // frame number each widget is next due
+
+
+//
+// run one display scheduler frame for the current page
+//
+void RunDisplayScheduler(void)
+{
+  char Str[40];
+  SFormatter Fmt;
+  const SDisplayWidget* Widget;
+  unsigned long Sent = 0;                     // 1 bit per widget sent this frame
+  byte Cntr;
+  int Best;                                   // widget to send next (-1 if none)
+  int Overdue, BestOverdue = 0;               // frames past deadline
+  byte Length;
+
+//
+// on a new page, every widget is due now: the byte budget paces them out
+//
+  if(GScheduledPage != GDisplayPage)
+  {
+    GScheduledPage = GDisplayPage;
+    for(Cntr = 0; Cntr < VNUMWIDGETS; Cntr++)
+      GWidgetDue[Cntr] = GDisplayFrame;
+  }
+//
+// if the status has changed (tune started or finished, ATU enabled or disabled),
+// the status widgets are due now
+//
+  if(GetStatusString() != GScheduledStatus)
+  {
+    GScheduledStatus = GetStatusString();
+    for(Cntr = 0; Cntr < VNUMWIDGETS; Cntr++)
+      if(GDisplayWidgets[Cntr].Source == StatusSource)
+        GWidgetDue[Cntr] = GDisplayFrame;
+  }
+
+  while(true)
+  {
+    Best = -1;
+    for(Cntr = 0; Cntr < VNUMWIDGETS; Cntr++)
+    {
+      Widget = GDisplayWidgets + Cntr;
+      if((Widget -> Page != GDisplayPage) || ((Sent & (1UL << Cntr)) != 0))
+        continue;
+      Overdue = (int)(GDisplayFrame - GWidgetDue[Cntr]);
+      if(Overdue < 0)
+        continue;                             // not due yet
+      if((Best < 0) || (Widget -> Priority > GDisplayWidgets[Best].Priority)
+         || ((Widget -> Priority == GDisplayWidgets[Best].Priority) && (Overdue > BestOverdue)))
+      {
+        Best = Cntr;
+        BestOverdue = Overdue;
+      }
+    }
+    if(Best < 0)
+      break;                                  // nothing more due
+//
+// make the command, and send it if it fits in what's left of the budget
+// (a value already displayed is dropped by the batch, and costs nothing)
+//
+    Widget = GDisplayWidgets + Best;
+    FormatBegin(&Fmt, Str, sizeof(Str));
+    FormatLiteral(&Fmt, Widget -> Attribute);
+    if(Widget -> IsText)
+      FormatLiteral(&Fmt, "=\"");
+    else
+      FormatChar(&Fmt, '=');
+    Widget -> Source(&Fmt, Widget -> Param);
+    if(Widget -> IsText)
+      FormatChar(&Fmt, '"');
+    Length = Fmt.Ptr - Str + 3;               // including the 3 byte terminator
+    if(GDisplayBytes + Length > GDisplayByteBudget)
+      break;                                  // stays due
+    BatchCommand(Str);
+    Sent |= (1UL << Best);
+    GWidgetDue[Best] = GDisplayFrame + Widget -> Period;
+  }
+  GDisplayFrame++;
+}
+
+
+
 //
 // NextionDisplayTick()
 // called from the LCD_UI_Tick() below
 // (separated to break the code up a bit)
 // this is only called if a display is present
+// the meter pages only update on the frames set by the governor; pages are
+// initialised at once, and the engineering and trip pages update every tick.
+// the periodic controls are sent by the display scheduler (RunDisplayScheduler)
 //
 void NextionDisplayTick(void)
 {
   char Str[20];
-  char Str2[20];
+  SFormatter Fmt;
   byte InitialPage;
-  unsigned int ADCMean, ADCPeak;
-  int Value;
-  bool ZValue;  
-  int X1, Y1, X2, Y2;
   int Forward, Reverse;
-  float X,Y;
-  float Angle;
+  bool FrameDue;
 
   nexLoop(nex_listen_list);
+  FrameDue = DisplayFrameDue();
   switch(GDisplayPage)
   {
     case eTransitioning:                            // do nothing if changing page
@@ -1234,11 +1694,10 @@ void NextionDisplayTick(void)
 ///////////////////////////////////////////////////
 
     case  eCrossedNeedlePage:                         // crossed needle VSWR page display
-      GUpdateMeterTicks++;                            // update ticks since last updated
       if(GInitialisePage == true)                     // load background pics
       {
         GInitialisePage = false;
-        p1Band.setText(GDisplayBandStrings[GBandDisplayed]);
+        BatchText("p1t1.txt", GDisplayBandStrings[GBandDisplayed]);   // p1Band
         SetCrossedNeedleImages();                     // get correct display scales
         GDisplayedForward = -100;                     // set illegal display angles
         GDisplayedReverse = -100;
@@ -1246,18 +1705,19 @@ void NextionDisplayTick(void)
         SetPeakButtonText();
         SetEnabledButtonText();
       }
-      else
+      else if(FrameDue)
       {
+        GUpdateMeterTicks++;                          // update frames since last updated
 //
 // first see what the angles should be, and if they are different from what's drawn.
 // we only trest this is we are NOT already redrawing the display.
-// redraw once a second even if no change
+// redraw every VNEEDLEKEEPALIVE frames even if no change
 //
         if(!GCrossedNeedleRedrawing)
         {
           Forward = GetCrossedNeedleDegrees(true, GIsPeakDisplay);
           Reverse = GetCrossedNeedleDegrees(false, GIsPeakDisplay);
-          if((Forward != GDisplayedForward) || (Reverse != GDisplayedReverse) || (GUpdateMeterTicks >= 50))
+          if((Forward != GDisplayedForward) || (Reverse != GDisplayedReverse) || (GUpdateMeterTicks >= VNEEDLEKEEPALIVE))
           {
             GCrossedNeedleRedrawing = true;           // if changed, set need to redraw display and required angles
             GDisplayedForward = Forward;
@@ -1274,68 +1734,23 @@ void NextionDisplayTick(void)
           GUpdateMeterTicks = 0;
           switch(GUpdateItem++)
           {
-            case 0:                                     // erase image
-              sendCommand("ref 1");
-              break;
-  
-            case 1:                                     // draw reverse power line
-              X1 = VXNEEDLEREVX1;
-              Y1 = VXNEEDLEY1;
-              Angle = (float)GDisplayedReverse * M_PI / 180.0;
-              X = X1 + VNEEDLESIZE * cos(Angle);
-              X2 = (int)X;
-              Y = Y1 - VNEEDLESIZE * sin(Angle);
-              Y2 = (int)Y;
-// get text commands
-              strcpy(Str, "line ");             // line
-              mysprintf(Str2, X1, false);
-              strcat(Str, Str2);
-              strcat(Str, ",");                 // line X1,
-              mysprintf(Str2, Y1, false);
-              strcat(Str, Str2);
-              strcat(Str, ",");                 // line X1,Y1,
-              mysprintf(Str2, X2, false);
-              strcat(Str, Str2);
-              strcat(Str, ",");                 // line X1,Y1,X2
-              mysprintf(Str2, Y2, false);
-              strcat(Str, Str2);
-              strcat(Str, ",BLUE");             // line X1,Y1,X2,Y2,BLUE
-              sendCommand(Str);
+            case 0:                                     // erase image, then draw both lines: sent in one batch
+              BatchCommand("ref 1");
+              BatchNeedleLine(GDisplayedReverse, false);
+              BatchNeedleLine(GDisplayedForward, true);
               break;
 
-            case 2:                                     // draw forward power line
-              X1 = VXNEEDLEFWDX1;
-              Y1 = VXNEEDLEY1;
-              Angle = (float)GDisplayedForward * M_PI / 180.0;
-              X = X1 - VNEEDLESIZE * cos(Angle);
-              X2 = (int)X;
-              Y = Y1 - VNEEDLESIZE * sin(Angle);
-              Y2 = (int)Y;
-// get text commands
-              strcpy(Str, "line ");             // line
-              mysprintf(Str2, X1, false);
-              strcat(Str, Str2);
-              strcat(Str, ",");                 // line X1,
-              mysprintf(Str2, Y1, false);
-              strcat(Str, Str2);
-              strcat(Str, ",");                 // line X1,Y1,
-              mysprintf(Str2, X2, false);
-              strcat(Str, Str2);
-              strcat(Str, ",");                 // line X1,Y1,X2
-              mysprintf(Str2, Y2, false);
-              strcat(Str, Str2);
-              strcat(Str, ",BLUE");             // line X1,Y1,X2,Y2,BLUE
-              sendCommand(Str);
+            case 1:                                     // on transmit, no dwell: next redraw can start
+              if(GDisplayTransmit)
+                GCrossedNeedleRedrawing = false;
               break;
-              
-            case 6: 
-              SetStatusString();
-              break;
-            case 7:                                     // end of dwell after redraw
+
+            case 3:                                     // end of dwell after redraw
               GCrossedNeedleRedrawing = false;
               break;
           }
         }   // switch
+        RunDisplayScheduler();                        // status, in the frames the needles leave room
       }
       break;
 /////////////////////////////////////////////
@@ -1343,198 +1758,47 @@ void NextionDisplayTick(void)
     case  ePowerBargraphPage:                         // bargraph page display
       if(GInitialisePage)
       {
-        p2Band.setText(GDisplayBandStrings[GBandDisplayed]);
+        BatchText("p2t5.txt", GDisplayBandStrings[GBandDisplayed]);   // p2Band
         SetPeakButtonText();
         SetEnabledButtonText();
         SetBargraphImages();                            // get correct display scales
         GInitialisePage = false;
       }
-      else
-        switch(GUpdateItem)
-        {
-          case 0:
-            Forward = GetPowerPercent(true, GIsPeakDisplay);
-            p2FwdBar.setValue(Forward);
-            break;
-  
-          case 4:
-            Forward = GetVSWRPercent();
-            p2VSWRBar.setValue(Forward);
-            break;
-  
-          case 8:
-            if(GIsPeakDisplay)
-              Forward = FindPeakPower(true);                 // get forward peak power, in watts
-            else
-              Forward = GetPowerReading(true);               // get forward power, in watts
-            mysprintf(Str, Forward, false);
-            p2FwdPower.setText(Str);
-  
-            mysprintf(Str, GVSWR*10, true);
-            p2VSWRTxt.setText(Str);
-            break;
-
-          case 10:
-            SetStatusString();
-            break;
-        }          
-      if (GUpdateItem++ >= 10)
-        GUpdateItem = 0;
+      else if(FrameDue)
+        RunDisplayScheduler();                          // bars, power, VSWR and status
       break;
 ////////////////////////////////////////////////
     
     case  eMeterPage:                                 // analogue meter page display
       if(GInitialisePage)
       {
-        p3Band.setText(GDisplayBandStrings[GBandDisplayed]);
+        BatchText("p3t1.txt", GDisplayBandStrings[GBandDisplayed]);   // p3Band
         SetPeakButtonText();
         SetEnabledButtonText();
         SetMeterImages();                            // get correct display scales
         GInitialisePage = false;
       }
-      else
-        switch(GUpdateItem)
-        {
-          case 0:
-            Forward = GetPowerMeterDegrees(true, GIsPeakDisplay);
-            p3Meter.setValue(Forward);
-            break;
-  
-          case 10:
-            Forward = GetVSWRPercent();
-            p3VSWRBar.setValue(Forward);
-            break;
-
-          case 14:
-            SetStatusString();
-            break;
-
-        }          
-      if (GUpdateItem++ >= 14)
-        GUpdateItem = 0;
+      else if(FrameDue)
+        RunDisplayScheduler();                         // meter, VSWR bar and status
       break;
 ////////////////////////////////////////////////
       
     case  eEngineeringPage:                           // engineering page display
       if(GInitialisePage)                       // initialise the controls not refreshed often
       {
-        mysprintf(Str, GTunedFrequency10, false);
-        p4FreqValue.setText(Str);
-        mysprintf(Str, GTXAntenna, false);
-        p4AntValue.setText(Str);
+        FormatBegin(&Fmt, Str, sizeof(Str));
+        FormatInt(&Fmt, GTunedFrequency10);
+        BatchText("p4t7.txt", Str);                 // p4FreqValue
+        FormatBegin(&Fmt, Str, sizeof(Str));
+        FormatInt(&Fmt, GTXAntenna);
+        BatchText("p4t8.txt", Str);                 // p4AntValue
         SetEnabledButtonText();
         SetHighLowZButtonText();
         SetCoarseButtonText();
         GInitialisePage = false;
       }
-      else                                      // update a display element: one per tick
-      {
-        switch(GDisplayItem)
-        {
-          case 0:                               // L Value
-            Value = GetInductance();
-            if(GDisplayedL != Value)
-            {
-              mysprintf(Str, Value, false); 
-              GDisplayedL = Value;
-              p4LValue.setText(Str);
-            }
-            break;
-      
-          case 2:                               // C Value
-            Value = GetCapacitance();
-            if(GDisplayedC != Value)
-            {
-              mysprintf(Str, Value, false); 
-              GDisplayedC = Value;
-              p4CValue.setText(Str);
-            }
-            break;
-      
-          case 4:                               // VSWR Value
-            Value = (int)(GVSWR*10.0);
-            if (GForwardPower == 0)
-            {
-              GDisplayedVSWR = 0;               // illegal value, so will always be redrawn
-              p4VSWRValue.setText("---");
-            }
-            else if(GDisplayedVSWR != Value)
-            {
-              mysprintf(Str, Value, true);          // 1dp
-              GDisplayedVSWR = Value;
-              p4VSWRValue.setText(Str);
-            }
-            break;
-      
-          case 6:                               // power Value
-            if(GDisplayedPower != GForwardPower)
-            {
-              mysprintf(Str, GForwardPower, false);   
-              GDisplayedPower = GForwardPower;
-              p4PowerValue.setText(Str);
-            }
-            break;
-      
-          case 8:                               // Vf Value
-            GetADCMeanAndPeak(true, &ADCMean, &ADCPeak);
-            mysprintf(Str, ADCMean, false); 
-            mysprintf(Str2, ADCPeak, false);
-            strcat(Str, " ");
-            strcat(Str, Str2);
-            p4VfValue.setText(Str);
-            break;
-      
-          case 10:                               // Vr Value
-            GetADCMeanAndPeak(false, &ADCMean, &ADCPeak);
-            mysprintf(Str, ADCMean, false); 
-            mysprintf(Str2, ADCPeak, false);
-            strcat(Str, " ");
-            strcat(Str, Str2);
-            p4VrValue.setText(Str);
-            break;
-      
-          case 12:                               // PTT & quick tune (won't change together)
-            if(GDisplayedPTT != GPTTPressed)
-            {
-              GDisplayedPTT = GPTTPressed;
-              if(GPTTPressed == true)
-                p4PTT.setText("PTT");
-              else
-                p4PTT.setText("no PTT");
-            }
-            if(GDisplayedQuick != GQuickTuneEnabled)
-            {
-              GDisplayedQuick = GQuickTuneEnabled;
-              if(GQuickTuneEnabled == true)
-                p4Quick.setText("Quick");
-              else
-                p4Quick.setText("Full");
-            }
-            break;
-      
-          case 14:                               // Status
-            SetStatusString();
-            break;
-      
-          case 16:                               // High/Low z
-            ZValue = GetHiLoZ();
-            if(GDisplayedZ != ZValue)
-            {
-              GDisplayedZ = ZValue;
-              SetHighLowZButtonText();
-            }
-            break;
-
-          case 18:
-            mysprintf(Str, GPACurrent, true);   // 1dp
-            p4Current.setText(Str); 
-            break;
-        }
-        if(GDisplayItem >= 20)
-          GDisplayItem = 0;
-        else
-          GDisplayItem++;
-      }
+      else
+        RunDisplayScheduler();                  // L, C, VSWR, power, ADC values etc
       break;
 
 //////////////////////////////////////////////////////////
@@ -1543,53 +1807,42 @@ void NextionDisplayTick(void)
       {
         if(GDisplayScale > VDISPLAYSCALE)
           GDisplayScale = VDISPLAYSCALE;
-        p5ScaleTxt.setText(GDisplayScaleStrings[GDisplayScale]);
-        if(GQuickTuneEnabled)
-          p5AlgBtn.setText("Quick");
-        else
-          p5AlgBtn.setText("Full");
+        BatchText("p5t1.txt", GDisplayScaleStrings[GDisplayScale]);   // p5ScaleTxt
+        DisplayAlgorithmSetting();
         GInitialisePage = false;
       }
       break;
 
 //////////////////////////////////////////////////////////////
     case  eTripPage:                            // protection page display
-      if(GInitialisePage)
-        GDisplayItem = 0;
       GInitialisePage = false;
-      if(((GTripInputBits>>(GDisplayItem>>1)) & 0b1) == 0b1)       // if trip bit set
-        strcpy(Str, "Tripped");
-      else
-        strcpy(Str, "OK");
-      
-      switch(GDisplayItem)
-      {
-        case 0:
-          p6VSWRTxt.setText(Str);
-          break;
-        case 2:
-          p6RevPwrTxt.setText(Str);
-          break;
-        case 4:
-          p6DrivePwrTxt.setText(Str);
-          break;
-        case 6:
-          p6TempTxt.setText(Str);
-          break;
-
-        case 8:
-          if(GTripInputBits == 0)
-            p6ResetBtn.setText("RESET");
-          else
-            p6ResetBtn.setText("tripped");
-          break;
-      }
-      if(GDisplayItem >= 12)                                      // allow some time for button presses
-        GDisplayItem = 0;
-      else
-        GDisplayItem++;
+      RunDisplayScheduler();                    // trip inputs and reset button
       break;
   }
+  nexBatchFlush();                                  // send this tick's display updates in one burst
+//
+// every batched write is charged to GDisplayBytes, including those made between ticks
+// (CAT handlers, status changes), which go out with the next tick's burst.
+// any excess over this tick's budget is charged to the next tick (at most one budget)
+//
+  if(GDisplayBytes > 2 * GDisplayByteBudget)
+    GDisplayBytes = GDisplayByteBudget;
+  else if(GDisplayBytes > GDisplayByteBudget)
+    GDisplayBytes -= GDisplayByteBudget;
+  else
+    GDisplayBytes = 0;
+}
+
+
+
+//
+// background service, called from the main loop between ticks
+// keeps the Nextion link moving: queued commands are sent, and touch events decoded, as the UART has room
+//
+void LCD_UI_Service(void)
+{
+  if(GNexDisplayPresent)
+    nexPoll();
 }
 
 
@@ -1673,7 +1926,7 @@ void LCD_UI_Tick(void)
 void ShowFrequency(char* FreqString)
 {
   if((GDisplayPage == eEngineeringPage) && GNexDisplayPresent)
-    p4FreqValue.setText(FreqString);
+    BatchText("p4t7.txt", FreqString);              // p4FreqValue
 }
 
 void ShowTune()
@@ -1684,11 +1937,13 @@ void ShowTune()
 void ShowAntenna(int Antenna)
 {
   char LocalStr[10];
-  LocalStr[0]=0;
+  SFormatter Fmt;
+
   if((GDisplayPage == eEngineeringPage) && GNexDisplayPresent)
   {
-    mysprintf(LocalStr, Antenna, false);
-    p4AntValue.setText(LocalStr);
+    FormatBegin(&Fmt, LocalStr, sizeof(LocalStr));
+    FormatInt(&Fmt, Antenna);
+    BatchText("p4t8.txt", LocalStr);                // p4AntValue
   }
 }
 
@@ -1772,10 +2027,10 @@ void DisplayBandBits(byte InputBits)                              // update to w
   {
     GBandDisplayed = NewBand;
     if(GDisplayPage == eCrossedNeedlePage)
-      p1Band.setText(GDisplayBandStrings[GBandDisplayed]);
+      BatchText("p1t1.txt", GDisplayBandStrings[GBandDisplayed]);     // p1Band
     else if(GDisplayPage == ePowerBargraphPage)
-      p2Band.setText(GDisplayBandStrings[GBandDisplayed]);
+      BatchText("p2t5.txt", GDisplayBandStrings[GBandDisplayed]);     // p2Band
     else if(GDisplayPage == eMeterPage)
-      p3Band.setText(GDisplayBandStrings[GBandDisplayed]);
+      BatchText("p3t1.txt", GDisplayBandStrings[GBandDisplayed]);     // p3Band
   }
 }
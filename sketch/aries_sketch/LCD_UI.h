@@ -44,6 +44,11 @@ void LCD_UI_Initialise(void);
 //
 void LCD_UI_Tick(void);
 
+//
+// background service, called from the main loop between ticks
+//
+void LCD_UI_Service(void);
+
 //
 // periodic timer tick for encoders
 // (this could be called more often than main tick)
@@ -55,14 +60,6 @@ void LCD_UI_EncoderTick(bool OddEncoder);
 //
 void SetTuneChanged();
 
-//
-// local version of "sprintf like" function
-// Adds a decimal point before last digit if 3rd parameter set
-// note integer value is signed and may be negative!
-//
-unsigned char mysprintf(char *dest, int Value, bool AddDP);
-
-
 // debug
 void ShowFrequency(char* FreqString);
 void ShowTune();
@@ -15,14 +15,34 @@
 #include "globalinclude.h"
 #include "cathandler.h"
 #include "LCD_UI.h"
+#include "patternsearch.h"
+#include "lnetwork.h"
+#include "formatter.h"
 
 
 
 #define VSUCCESSVSWR 150                  // threshold for "successful" tune VSWR = 1.5
 #define VSUCCESSQUICKVSWR 120             // threshold for "successful" quick tune VSWR = 1.2
+#define VBYPASSVSWR 120                   // full tune isn't needed if null or stored solution is below VSWR = 1.2
+#define VNEIGHBOURSEARCH 50               // +/- range of stored solutions tried by quick tune (10KHz units)
+#define VMAXNEIGHBOURS 6                  // max number of stored solutions tried by quick tune
 #define VMAXVSWR 65535
 #define VALGTICKSPERSTEP 2                // executes once per 3 ticks
 #define VALGSTARTDELAYTICKS 20            // delay after PTT before algorithm starts properly, to allow power to ramp up
+#define VTOPOLOGYSEARCH 50                // +/- range of stored solutions checked for Z setting (10KHz units)
+#define VTOPOLOGYVOTES 4                  // max number of stored solutions checked for Z setting
+#define VNUMCANDIDATES 3                  // number of coarse stage candidates kept for refinement
+#define VMAXLOGSTEPS 8                    // max number of L or C settings in the log reactance grid
+#define VDEFAULTRESUMETIME 30             // default time (s) a cancelled tune can be resumed for
+#define VMINTUNEPOWER 1.0F                // min forward power (W) for a valid VSWR reading
+#define VPOWERLOWPC 50                    // forward power band around tune start level (%)
+#define VPOWERHIGHPC 200
+#define VPOWERSTEPPC 20                   // max change (%) between ticks for power to be stable
+#define VPOWERSTEPWATTS 1.0F              // change (W) always allowed, for QRP levels
+#define VPOWERAVERAGE 4                   // forward power averaging time constant (ticks)
+#define VPOWERSTABLETICKS 2               // number of stable ticks needed to measure VSWR
+#define VMAXPOWERHOLDTICKS 30             // ticks a step is held for steady power before it is measured anyway
+#define VMAXNOPOWERTICKS 250              // ticks a step is held with no drive (below VMINTUNEPOWER) before the tune is cancelled
 
 
 //
@@ -37,7 +57,13 @@ enum EAlgorithmState
   eAlgMid2,
   eAlgFine1, 
   eAlgFine2,
-  eAlgEEPROMWrite   
+  eAlgEEPROMWrite,
+  eAlgPattern,
+  eAlgProbe,
+  eAlgClassify,
+  eAlgBypass,
+  eAlgLogGrid,
+  eAlgNeighbour
 }; 
 
 
@@ -50,7 +76,13 @@ const char* StateNames[]=
   "2nd Mid Step: ",
   "1st Fine Step: ",
   "2nd Fine Step: ",
-  "Write EEPROM"
+  "Write EEPROM",
+  "Pattern search: ",
+  "Probe: ",
+  "Classify Z: ",
+  "Bypass check: ",
+  "Log reactance grid: ",
+  "Neighbour check: "
 };
 
 
@@ -59,7 +91,7 @@ const char* StateNames[]=
 //
 struct STuneParams
 {
-  byte FreqMax;                       // max freq (MHz) covered by this row
+  unsigned int FreqMax;               // max freq (10KHz units) covered by this row
   byte Alg1StartRow;                  // starting row for table 2 (alg stage 1 params)
   byte Alg1NumRows;                   // number of rows at this frequency in that table  
   byte LMax;                          // max inductance (0-255)
@@ -83,6 +115,44 @@ struct SSweepSet
   byte FixedParam;                    // value to use for the paramter not stepped
 };
 
+//
+// structure for a band descriptor: the tune table rows are generated from these (see tablegen.h)
+// the band's stage 1 sweeps are NumTries sets of 4 sweeps (loZ step C, loZ step L, hiZ step C, hiZ step L)
+// from 0 to SweepMax, with the parameter not stepped fixed at 0, FixedStep, 2*FixedStep...
+// NumTries=0 for a general coverage row: it uses the sweeps and parameters of the band below
+//
+struct SBandDescriptor
+{
+  unsigned int FreqMax;               // max freq (10KHz units) covered by this row
+  byte LMax;                          // max inductance (0-255)
+  byte CMax;                          // max capacitance (0-255)
+  byte NumTries;                      // number of sets of 4 stage 1 sweeps
+  byte SweepMax;                      // stage 1 max value for parameter being stepped
+  byte SweepStep;                     // stage 1 step size
+  byte FixedStep;                     // stage 1 step between fixed values
+  byte Stage1bStep;                   // step size to use  (min=0, max=param max)
+  byte Stage2MidRange;                // +/- range for mid search
+  byte Stage2MidStep;                 // step size for mid step
+  byte Stage2FineRange;               // +/- range for fine search
+};
+
+
+//
+// tuning strategy interface
+// the algorithm sequencer (AlgorithmTick) measures VSWR, keeps the best found and records the trace;
+// the strategy decides which L/C/Z candidate to try next.
+// Initialise() sets GAlgState and the first candidate in GCurrentSetting
+// (StartQuick true for a quick tune around the current hardware solution)
+// Step() is passed the VSWR just measured; it sets the next candidate in GCurrentSetting and returns true,
+// or returns false when its search is complete. GBestFoundSoFar is then assessed as the result.
+//
+struct STuneStrategy
+{
+  const char* Name;                             // short name for display
+  void (*Initialise)(bool StartQuick);          // set up first candidate
+  bool (*Step)(unsigned int VSWR);              // find next candidate; false if finished
+};
+
 
 //
 // structure for best result found
@@ -98,111 +168,33 @@ struct SResult
 
 
 //
-// array of frequency table records;
-// this is indexed by the GFreqRow variable
-// the entire algorithm can be changed by replacing this table
+// checkpoint of a cancelled tune, so that it can resume where it left off
+// the strategy's own working data (candidate list, probe measurements, pattern search)
+// is left in place while idle; it is only reset when a new tune starts
 //
-#define VNUMTUNEROWS 6                // this tells how far to step
-const STuneParams GTuneParamArray[] = 
-// FMax,startrow,#rows, Lmax, Cmax, S1bStep, S2Mid+-, S2MidStep, S2Fine+- 
+struct SCheckpoint
 {
-  {1, 0, 12, 255, 255, 24, 32, 4, 8},        // 1.8MHz band
-  {3, 12, 12, 255, 255, 24, 32, 4, 8},        // 3.5MHz band
-  {7, 24, 12, 210, 210, 12, 24, 4, 8},        // 7MHz band
-  {14, 36, 12, 100, 100, 6, 12, 2, 8},        // 14MHz band
-  {29, 48, 12, 60, 60, 3, 8, 1, 8},        // 21 & 28MHz band
-  {64, 60, 12, 30, 30, 2, 8, 1, 8},        // 50MHz band
+  bool Valid;                         // true if a tune can be resumed
+  EAlgorithmState AlgState;           // sequencer state when cancelled
+  byte Stage1Row;                     // stage 1 row
+  SSweepSet CurrentSweep;             // current sweep
+  SResult CurrentSetting;             // candidate that was to be measured next
+  SResult BestFoundSoFar;             // best found
+  bool IsQuickTune;                   // true if a quick tune
+  const STuneStrategy* Strategy;      // strategy running the tune
+  unsigned int Frequency10;           // frequency and antenna of the tune
+  byte Antenna;
+  unsigned long Time;                 // time cancelled (ms)
 };
 
 
 //
-// array of frequency table records;
-// this is indexed by the GFreqRow variable
-// 
-#define VNUMSTAGE1ROWS 72                 // this tells how far to step
-
-
-const SSweepSet GStage1Array[] = 
-// highZ,LSweep, MinStepped,MaxStepped, Step, Fixed
-{
-  {false, false, 0, 255, 24, 0},            // 1.8MHz try1 loZ step C
-  {false, true, 0, 255, 24, 0},             // 1.8MHz try1 loz step L
-  {true, false, 0, 255, 24, 0},             // 1.8MHz try1 hiZ step C
-  {true, true, 0, 255, 24, 0},              // 1.8MHz try1 hiZ step L
-  {false, false, 0, 255, 24, 48},           // 1.8MHz try2 loZ step C
-  {false, true, 0, 255, 24, 48},            // 1.8MHz try2 loz step L
-  {true, false, 0, 255, 24, 48},            // 1.8MHz try2 hiZ step C
-  {true, true, 0, 255, 24, 48},             // 1.8MHz try2 hiZ step L
-  {false, false, 0, 255, 24, 96},           // 1.8MHz try3 loZ step C
-  {false, true, 0, 255, 24, 96},            // 1.8MHz try3 loz step L
-  {true, false, 0, 255, 24, 96},            // 1.8MHz try3 hiZ step C
-  {true, true, 0, 255, 24, 96},             // 1.8MHz try3 hiZ step L
-
-  {false, false, 0, 255, 24, 0},            // 3.5MHz try1 loZ step C
-  {false, true, 0, 255, 24, 0},             // 3.5MHz try1 loz step L
-  {true, false, 0, 255, 24, 0},             // 3.5MHz try1 hiZ step C
-  {true, true, 0, 255, 24, 0},              // 3.5MHz try1 hiZ step L
-  {false, false, 0, 255, 24, 36},           // 3.5MHz try2 loZ step C
-  {false, true, 0, 255, 24, 36},            // 3.5MHz try2 loz step L
-  {true, false, 0, 255, 24, 36},            // 3.5MHz try2 hiZ step C
-  {true, true, 0, 255, 24, 36},             // 3.5MHz try2 hiZ step L
-  {false, false, 0, 255, 24, 72},           // 3.5MHz try3 loZ step C
-  {false, true, 0, 255, 24, 72},            // 3.5MHz try3 loz step L
-  {true, false, 0, 255, 24, 72},            // 3.5MHz try3 hiZ step C
-  {true, true, 0, 255, 24, 72},             // 3.5MHz try3 hiZ step L
-
-  {false, false, 0, 210, 20, 0},            // 7MHz try1 loZ step C
-  {false, true, 0, 210, 20, 0},             // 7MHz try1 loz step L
-  {true, false, 0, 210, 20, 0},             // 7MHz try1 hiZ step C
-  {true, true, 0, 210, 20, 0},              // 7MHz try1 hiZ step L
-  {false, false, 0, 210, 20, 18},           // 7MHz try2 loZ step C
-  {false, true, 0, 210, 20, 18},            // 7MHz try2 loz step L
-  {true, false, 0, 210, 20, 18},            // 7MHz try2 hiZ step C
-  {true, true, 0, 210, 20, 18},             // 7MHz try2 hiZ step L
-  {false, false, 0, 210, 20, 36},           // 7MHz try3 loZ step C
-  {false, true, 0, 210, 20, 36},            // 7MHz try3 loz step L
-  {true, false, 0, 210, 20, 36},            // 7MHz try3 hiZ step C
-  {true, true, 0, 210, 20, 36},             // 7MHz try3 hiZ step L
-
-  {false, false, 0, 100, 10, 0},              // 14MHz try1 loZ step C
-  {false, true, 0, 100, 10, 0},               // 14MHz try1 loz step L
-  {true, false, 0, 100, 10, 0},               // 14MHz try1 hiZ step C
-  {true, true, 0, 100, 10, 0},                // 14MHz try1 hiZ step L
-  {false, false, 0, 100, 10, 18},             // 14MHz try2 loZ step C
-  {false, true, 0, 100, 10, 18},              // 14MHz try2 loz step L
-  {true, false, 0, 100, 10, 18},              // 14MHz try2 hiZ step C
-  {true, true, 0, 100, 10, 18},               // 14MHz try2 hiZ step L
-  {false, false, 0, 100, 10, 36},             // 14MHz try3 loZ step C
-  {false, true, 0, 100, 10, 36},              // 14MHz try3 loz step L
-  {true, false, 0, 100, 10, 36},              // 14MHz try3 hiZ step C
-  {true, true, 0, 100, 10, 36},               // 14MHz try3 hiZ step L
-
-  {false, false, 0, 55, 5, 0},              // 21-28MHz try1 loZ step C
-  {false, true, 0, 55, 5, 0},               // 21-28MHz try1 loz step L
-  {true, false, 0, 55, 5, 0},               // 21-28MHz try1 hiZ step C
-  {true, true, 0, 55, 5, 0},                // 21-28MHz try1 hiZ step L
-  {false, false, 0, 55, 5, 8},              // 21-28MHz try2 loZ step C
-  {false, true, 0, 55, 5, 8},               // 21-28MHz try2 loz step L
-  {true, false, 0, 55, 5, 8},               // 21-28MHz try2 hiZ step C
-  {true, true, 0, 55, 5, 8},                // 21-28MHz try2 hiZ step L
-  {false, false, 0, 55, 5, 16},             // 21-28MHz try3 loZ step C
-  {false, true, 0, 55, 5, 16},              // 21-28MHz try3 loz step L
-  {true, false, 0, 55, 5, 16},              // 21-28MHz try3 hiZ step C
-  {true, true, 0, 55, 5, 16},               // 21-28MHz try3 hiZ step L
-
-  {false, false, 0, 20, 2, 0},              // 50MHz try1 loZ step C
-  {false, true, 0, 20, 2, 0},               // 50MHz try1 loz step L
-  {true, false, 0, 20, 2, 0},               // 50MHz try1 hiZ step C
-  {true, true, 0, 20, 2, 0},                // 50MHz try1 hiZ step L
-  {false, false, 0, 20, 2, 3},              // 50MHz try2 loZ step C
-  {false, true, 0, 20, 2, 3},               // 50MHz try2 loz step L
-  {true, false, 0, 20, 2, 3},               // 50MHz try2 hiZ step C
-  {true, true, 0, 20, 2, 3},                // 50MHz try2 hiZ step L
-  {false, false, 0, 20, 2, 6},              // 50MHz try3 loZ step C
-  {false, true, 0, 20, 2, 6},               // 50MHz try3 loz step L
-  {true, false, 0, 20, 2, 6},               // 50MHz try3 hiZ step C
-  {true, true, 0, 20, 2, 6},                // 50MHz try3 hiZ step L
-};
+// the frequency dependent tune tables (GTuneParamArray, GStage1Array)
+// are generated at compile time from the band descriptors in tunetables.h.
+// that is in its own file so that it can be regenerated by the host tune table optimiser
+//
+#include "tunetables.h"
+#include "tablegen.h"
 
 
 
@@ -230,6 +222,61 @@ SResult GCurrentSetting;        // current L/C/Z and VSWR
 SResult GBestFoundSoFar;        // best found so far
 SSweepSet GCurrentSweep;        // paramters for current sweep
 
+//
+// tuning strategy selection. The selected strategy is latched when a tune starts.
+//
+byte GTuneStrategy;                             // selected strategy (index into GStrategyList)
+byte GProbeNumber;                              // probe being measured by model strategy
+bool GModelFallback;                            // true if model strategy has fallen back to a search
+//
+// Z setting classification before the table coarse stage
+//
+bool GZCommitted;                               // true if coarse stage searches one Z setting only
+bool GCommittedHighZ;                           // the Z setting to search
+bool GOtherZTried;                              // true if the other Z setting has been searched after a failed tune
+byte GBypassProbe;                              // 0: null solution being measured; 1: stored solution
+//
+// quick tune: stored solutions at nearby frequencies, tried before the fine search
+//
+SResult GNeighbours[VMAXNEIGHBOURS];            // distinct stored solutions, nearest frequency first
+byte GNumNeighbours;                            // number in list
+byte GNextNeighbour;                            // next one to try
+//
+// log reactance grid strategy
+//
+byte GLogLCodes[VMAXLOGSTEPS];                  // grid L settings
+byte GLogCCodes[VMAXLOGSTEPS];                  // grid C settings
+byte GNumLogL;                                  // number of grid settings
+byte GNumLogC;
+byte GLogLIndex;                                // grid point being measured
+byte GLogCIndex;
+byte GLogBestLIndex;                            // best grid point found
+byte GLogBestCIndex;
+SResult GOtherZBest;                            // best found with the first Z setting
+//
+// best few candidates from the coarse stage, in distinct regions, best first
+//
+SResult GCandidates[VNUMCANDIDATES];            // candidate list
+byte GNumCandidates;                            // number of candidates in list
+byte GNextCandidate;                            // next candidate to refine
+SResult GRefinedBest;                           // best result of the candidates refined so far
+//
+// resume after PTT drop
+//
+SCheckpoint GCheckpoint;                        // checkpoint of cancelled tune
+byte GResumeTime = VDEFAULTRESUMETIME;          // time (s) a cancelled tune can be resumed for; 0 = never
+//
+// forward power gating
+//
+float GAveragePower;                            // averaged forward power (W)
+float GTuneRefPower;                            // averaged forward power at tune start (W); 0 until measured
+float GLastPower;                               // averaged forward power at last tick
+byte GPowerStableCount;                         // number of consecutive ticks with power stable and in band
+byte GPowerHoldTicks;                           // number of ticks the current step has been held
+byte GNoPowerTicks;                             // number of ticks held with no drive power
+bool GMeasureGated;                             // true if the last VSWR was measured with steady, in band power
+const STuneStrategy* GActiveStrategy;           // strategy running the current tune
+
 //
 // debug
 //
@@ -238,9 +285,64 @@ char DebugText[VDEBTEXTSIZE];
 
 
 //
-// forward reference to function later in file
+// tune trace recorder
+// a RAM ring buffer holds every measured algorithm step, and a second ring buffer holds a summary of each tune
+// recording a step is just a store of a fixed size struct, so it doesn't slow the tune down
+// (unlike printing to serial). Read out by the PC with ZZOD; the records are sent a few per tick.
+// the ring buffer sizes must be powers of 2
+//
+#define VTRACESTEPS 512                 // number of steps held (8 bytes each)
+#define VTRACETUNES 8                   // number of tune summaries held
+#define VTRACEMSGLENGTH 32              // number of characters in a trace record CAT message
+#define VTRACEMSGSPERTICK 4             // trace records sent per tick during a dump
+#define VTRACESUMMARYDUE 0xFFFF         // dump step value: the tune summary hasn't been sent yet
+
+#define VTRACERESULTFAIL 0              // tune result values for summary
+#define VTRACERESULTSUCCESS 1
+#define VTRACERESULTCANCELLED 2
+
+struct STraceStep
+{
+  byte State;                           // algorithm state (EAlgorithmState)
+  byte LValue;                          // inductance value
+  byte CValue;                          // capacitance value
+  bool HighZ;                           // true for high Z
+  uint16_t VSWR;                        // 100* VSWR measured
+  uint16_t TickStamp;                   // algorithm tick count when measured
+};
+
+struct STraceTune
+{
+  uint16_t FirstStep;                   // step count at start of tune
+  uint16_t NumSteps;                    // number of steps recorded
+  uint16_t StartTick;                   // algorithm tick count at start of tune
+  uint16_t Duration;                    // tune duration, ticks
+  byte StartState;                      // first algorithm state
+  bool IsQuick;                         // true if it started as a quick tune
+  byte Result;                          // fail, success or cancelled
+  byte LValue;                          // final solution
+  byte CValue;
+  bool HighZ;
+  uint16_t VSWR;                        // 100* final VSWR
+};
+
+STraceStep GTraceSteps[VTRACESTEPS];    // step ring buffer
+STraceTune GTraceTunes[VTRACETUNES];    // tune summary ring buffer
+uint16_t GTraceStepCount;               // free running count of steps recorded
+uint16_t GTraceTuneCount;               // free running count of tunes recorded (numbers the tunes)
+byte GTraceTunesHeld;                   // number of tune summaries held (saturates at VTRACETUNES)
+bool GTraceTuneOpen;                    // true if a tune summary is being recorded
+uint16_t GTraceDumpTune;                // dump: tune being sent
+uint16_t GTraceDumpEnd;                 // dump: tune count when requested (dump complete when reached)
+uint16_t GTraceDumpStep;                // dump: next step of the tune to send
+uint16_t GAlgTickStamp;                 // free running count of algorithm ticks (16ms)
+
+
+//
+// forward references to functions later in file
 //
 void InitiateTune(bool StartQuick);
+void CancelAlgorithm(void);
 
 
 
@@ -256,26 +358,179 @@ void InitialiseAlgorithm(void)
 
 
 
+//
+// trace: open a new tune summary record
+//
+void TraceStartTune(bool IsQuick)
+{
+  STraceTune* Ptr;
+
+  Ptr = GTraceTunes + (GTraceTuneCount & (VTRACETUNES-1));
+  Ptr -> FirstStep = GTraceStepCount;
+  Ptr -> NumSteps = 0;
+  Ptr -> StartTick = GAlgTickStamp;
+  Ptr -> Duration = 0;
+  Ptr -> StartState = (byte)GAlgState;
+  Ptr -> IsQuick = IsQuick;
+  Ptr -> Result = VTRACERESULTCANCELLED;
+  Ptr -> VSWR = 0;
+  GTraceTuneOpen = true;
+}
+
+
+//
+// trace: record one measured step from the current setting
+//
+void TraceStep(void)
+{
+  STraceStep* Ptr;
+
+  Ptr = GTraceSteps + (GTraceStepCount & (VTRACESTEPS-1));
+  Ptr -> State = (byte)GAlgState;
+  Ptr -> LValue = GCurrentSetting.LValue;
+  Ptr -> CValue = GCurrentSetting.CValue;
+  Ptr -> HighZ = GCurrentSetting.HighZ;
+  Ptr -> VSWR = min(GCurrentSetting.VSWR, VMAXVSWR);
+  Ptr -> TickStamp = GAlgTickStamp;
+  GTraceStepCount++;
+}
+
+
+//
+// trace: close the current tune summary record with the best solution found
+//
+void TraceEndTune(byte Result)
+{
+  STraceTune* Ptr;
+
+  if(GTraceTuneOpen)
+  {
+    Ptr = GTraceTunes + (GTraceTuneCount & (VTRACETUNES-1));
+    Ptr -> NumSteps = GTraceStepCount - Ptr -> FirstStep;
+    Ptr -> Duration = GAlgTickStamp - Ptr -> StartTick;
+    Ptr -> Result = Result;
+    Ptr -> LValue = GBestFoundSoFar.LValue;
+    Ptr -> CValue = GBestFoundSoFar.CValue;
+    Ptr -> HighZ = GBestFoundSoFar.HighZ;
+    Ptr -> VSWR = min(GBestFoundSoFar.VSWR, VMAXVSWR);
+    GTraceTuneCount++;
+    if(GTraceTunesHeld < VTRACETUNES)
+      GTraceTunesHeld++;
+    GTraceTuneOpen = false;
+  }
+}
+
+
+//
+// start sending the trace of the last few tunes to the PC, oldest first
+// the records are sent by TraceDumpTick(), so a long dump doesn't hold up the tick.
+// each tune is a summary record followed by its step records (if still held in the ring buffer):
+// summary: T NNNNN SS Q NNNNN DDDDD R LLL CCC Z VVVVV (no spaces)
+//   tune number, start state, 1 if quick, steps, duration (ticks), result (0 fail, 1 OK, 2 cancelled), final L, C, Z, 100*VSWR
+// step:    S SS LLL CCC Z VVVVV TTTTT
+//   state, L, C, Z, 100*VSWR, ticks since tune start
+//
+void SendTuneTrace(byte NumTunes)
+{
+  NumTunes = min(NumTunes, GTraceTunesHeld);
+  GTraceDumpEnd = GTraceTuneCount;
+  GTraceDumpTune = GTraceTuneCount - NumTunes;
+  GTraceDumpStep = VTRACESUMMARYDUE;
+}
+
+
+//
+// send the next few records of a tune trace dump
+// records overwritten since the dump was requested are skipped
+//
+void TraceDumpTick(void)
+{
+  char Str[VTRACEMSGLENGTH+1];
+  SFormatter Fmt;
+  STraceTune* TunePtr;
+  STraceStep* StepPtr;
+  uint16_t StepIndex;
+  byte MsgCount = 0;
+
+  while((GTraceDumpTune != GTraceDumpEnd) && (MsgCount < VTRACEMSGSPERTICK))
+  {
+    TunePtr = GTraceTunes + (GTraceDumpTune & (VTRACETUNES-1));
+    if((uint16_t)(GTraceTuneCount - GTraceDumpTune) > VTRACETUNES)
+      GTraceDumpStep = TunePtr -> NumSteps;                         // summary overwritten: skip the tune
+    else if(GTraceDumpStep == VTRACESUMMARYDUE)
+    {
+      FormatBegin(&Fmt, Str, sizeof(Str));
+      FormatChar(&Fmt, 'T');
+      FormatField(&Fmt, GTraceDumpTune, 5);
+      FormatField(&Fmt, TunePtr -> StartState, 2);
+      FormatField(&Fmt, TunePtr -> IsQuick, 1);
+      FormatField(&Fmt, TunePtr -> NumSteps, 5);
+      FormatField(&Fmt, TunePtr -> Duration, 5);
+      FormatField(&Fmt, TunePtr -> Result, 1);
+      FormatField(&Fmt, TunePtr -> LValue, 3);
+      FormatField(&Fmt, TunePtr -> CValue, 3);
+      FormatField(&Fmt, TunePtr -> HighZ, 1);
+      FormatField(&Fmt, TunePtr -> VSWR, 5);
+      MakeCATMessageString(eZZOD, Str);
+      MsgCount++;
+      GTraceDumpStep = 0;
+      continue;
+    }
+//
+// then the steps that haven't been overwritten
+//
+    if(GTraceDumpStep < TunePtr -> NumSteps)
+    {
+      StepIndex = TunePtr -> FirstStep + GTraceDumpStep++;
+      if((uint16_t)(GTraceStepCount - StepIndex) > VTRACESTEPS)
+        continue;
+      StepPtr = GTraceSteps + (StepIndex & (VTRACESTEPS-1));
+      FormatBegin(&Fmt, Str, sizeof(Str));
+      FormatChar(&Fmt, 'S');
+      FormatField(&Fmt, StepPtr -> State, 2);
+      FormatField(&Fmt, StepPtr -> LValue, 3);
+      FormatField(&Fmt, StepPtr -> CValue, 3);
+      FormatField(&Fmt, StepPtr -> HighZ, 1);
+      FormatField(&Fmt, StepPtr -> VSWR, 5);
+      FormatField(&Fmt, (uint16_t)(StepPtr -> TickStamp - TunePtr -> StartTick), 5);
+      MakeCATMessageString(eZZOD, Str);
+      MsgCount++;
+    }
+    else
+    {
+      GTraceDumpTune++;                                             // on to the next tune
+      GTraceDumpStep = VTRACESUMMARYDUE;
+    }
+  }
+}
+
+
+
 //
 // find the frequency row to use
 // sets the row variable for tuning parameters to use
-// paramters is the required frequency (units of MHz)
-// step DOWN through the rows
+// paramters is the required frequency (units of 10KHz, as GTunedFrequency10)
+// binary search of the rows, which are in ascending frequency order
 // 
-void FindFreqRow(byte FrequencyMHz)
+void FindFreqRow(unsigned int Frequency10)
 {
-  int Row;               // row value being checked
+  int Lower, Upper, Row;                                // search range; row being checked
 
-  GFreqRow = 0;                                         // point to lowest freq by default
-  for (Row=VNUMTUNEROWS-1; Row >= 0; Row--)                // step through all rows
+  Lower = 0;                                            // find first row with FreqMax >= frequency
+  Upper = VNUMTUNEROWS-1;                               // (the last row covers everything above)
+  while (Lower < Upper)
   {
-    if(FrequencyMHz <= GTuneParamArray[Row].FreqMax)
-      GFreqRow = Row;
+    Row = (Lower + Upper) >> 1;
+    if(Frequency10 <= GTuneParamArray[Row].FreqMax)
+      Upper = Row;
+    else
+      Lower = Row + 1;
   }
+  GFreqRow = Lower;
 #ifdef CONDITIONAL_ALG_DEBUG
     Serial.print("F=");
-    Serial.print(FrequencyMHz);
-    Serial.print(" MHz; 1st table row = ");
+    Serial.print(Frequency10);
+    Serial.print(" x10KHz; 1st table row = ");
     Serial.print(GFreqRow);
     Serial.println();
 #endif
@@ -374,6 +629,49 @@ int GetVSWR(void)
 }
 
 
+//
+// forward power gate: called every tick during a tune
+// works on the unrounded power averaged over a few ticks, so QRP levels don't read as
+// 1W steps; changes up to VPOWERSTEPWATTS are always allowed for the same reason.
+// below VMINTUNEPOWER the VSWR reading isn't valid (it reads 1.0): don't measure.
+// the first stable reading sets the tune start reference level. Then power must be
+// within a band around that, and within VPOWERSTEPPC of the previous tick.
+// (AlgorithmTick measures anyway if a step is held too long with power above VMINTUNEPOWER:
+// see VMAXPOWERHOLDTICKS; with no drive it never measures, and cancels after VMAXNOPOWERTICKS)
+//
+void UpdatePowerGate(void)
+{
+  float Power;
+  float Tolerance;
+  bool InBand;
+  bool Stable;
+
+  GAveragePower += (GForwardWatts - GAveragePower) / VPOWERAVERAGE;
+  Power = GAveragePower;
+  if(Power < VMINTUNEPOWER)
+  {
+    GPowerStableCount = 0;
+  }
+  else
+  {
+    Tolerance = max(GLastPower * VPOWERSTEPPC / 100.0F, VPOWERSTEPWATTS);
+    Stable = (fabs(Power - GLastPower) <= Tolerance);
+    if(Stable && (GTuneRefPower == 0.0F))
+      GTuneRefPower = Power;                                // reference level
+    InBand = (Power >= GTuneRefPower * VPOWERLOWPC / 100.0F - VPOWERSTEPWATTS) &&
+             (Power <= GTuneRefPower * VPOWERHIGHPC / 100.0F + VPOWERSTEPWATTS);
+    if(Stable && InBand)
+    {
+      if(GPowerStableCount < VPOWERSTABLETICKS)
+        GPowerStableCount++;
+    }
+    else
+      GPowerStableCount = 0;
+  }
+  GLastPower = Power;
+}
+
+
 //
 // get start settings into current setting from sweep
 //
@@ -404,13 +702,24 @@ bool GetStage1Row(bool IsFirst)
   byte AbsoluteRow;
   
   if(IsFirst)
-    GStage1Row = 0;                                 // point at first row
-  else
   {
-    GStage1Row++;                                   // point at next row, and check if we have run out
-    if(GStage1Row >= GTuneParamArray[GFreqRow].Alg1NumRows)
-      Result = false;
+    GStage1Row = 0;                                 // point at first row
+    GNumCandidates = 0;                             // and start a new candidate list
+    GNextCandidate = 0;
+    GRefinedBest.VSWR = VMAXVSWR;
   }
+  else
+    GStage1Row++;                                   // point at next row
+//
+// if the Z setting has been decided, skip rows for the other one
+// then check if we have run out
+//
+  if(GZCommitted)
+    while((GStage1Row < GTuneParamArray[GFreqRow].Alg1NumRows) &&
+          (GStage1Array[GStage1Row + GTuneParamArray[GFreqRow].Alg1StartRow].IsHighZ != GCommittedHighZ))
+      GStage1Row++;
+  if(GStage1Row >= GTuneParamArray[GFreqRow].Alg1NumRows)
+    Result = false;
 //
 // if there are rows left, copy current one out and set up for sweep
 // with Z set, and L,C at first values
@@ -432,7 +741,186 @@ bool GetStage1Row(bool IsFirst)
 
 
 //
-// function called to assess tune result.
+// decide whether the coarse stage can search just one Z setting
+// uses the load estimated by the model from the probe measurements,
+// and the Z setting of stored solutions at nearby frequencies on this antenna.
+// commit to the model result unless all the nearby solutions (at least 2) disagree;
+// with no model result, commit if at least 2 nearby solutions all agree.
+//
+void ClassifyTopology(void)
+{
+  byte HighVotes = 0;
+  byte LowVotes = 0;
+  byte L, C;
+  bool HighZ;
+  bool ModelHighZ;
+  bool ModelKnown;
+  int Offset;
+
+  for(Offset = 0; (Offset <= VTOPOLOGYSEARCH) && ((HighVotes + LowVotes) < VTOPOLOGYVOTES); Offset++)
+  {
+    if(GetStoredSolution((int)GTunedFrequency10 + Offset, &L, &C, &HighZ))
+      HighZ ? HighVotes++ : LowVotes++;
+    if((Offset != 0) && GetStoredSolution((int)GTunedFrequency10 - Offset, &L, &C, &HighZ))
+      HighZ ? HighVotes++ : LowVotes++;
+  }
+
+  ModelKnown = FindModelTopology(&ModelHighZ);
+  if(ModelKnown)
+  {
+    GCommittedHighZ = ModelHighZ;
+    if(ModelHighZ)
+      GZCommitted = !((LowVotes >= 2) && (HighVotes == 0));
+    else
+      GZCommitted = !((HighVotes >= 2) && (LowVotes == 0));
+  }
+  else if((HighVotes + LowVotes) >= 2)
+  {
+    GCommittedHighZ = (HighVotes != 0);
+    GZCommitted = ((HighVotes == 0) || (LowVotes == 0));
+  }
+#ifdef CONDITIONAL_ALG_DEBUG
+  Serial.print("Z classify: model=");
+  Serial.print(ModelKnown ? (ModelHighZ ? "HiZ" : "LoZ") : "none");
+  Serial.print(" stored HiZ=");
+  Serial.print(HighVotes);
+  Serial.print(" LoZ=");
+  Serial.print(LowVotes);
+  Serial.print(GZCommitted ? (GCommittedHighZ ? "; search HiZ" : "; search LoZ") : "; search both");
+  Serial.println();
+#endif
+}
+
+
+//
+// table search finished.
+// if it only searched one Z setting and didn't succeed, search the other; returns true if that has started.
+// at the end, the better result of the two searches is the one kept
+//
+bool TryOtherTopology(void)
+{
+  if(GZCommitted && !GOtherZTried && (GBestFoundSoFar.VSWR >= VSUCCESSVSWR))
+  {
+    GOtherZTried = true;
+    GCommittedHighZ = !GCommittedHighZ;
+    GOtherZBest = GBestFoundSoFar;
+    GBestFoundSoFar.VSWR = VMAXVSWR;
+    GAlgState = eAlgCoarse1;
+    GetStage1Row(true);
+    return true;
+  }
+  if(GOtherZTried && (GOtherZBest.VSWR < GBestFoundSoFar.VSWR))
+    GBestFoundSoFar = GOtherZBest;
+  return false;
+}
+
+
+
+//
+// start a full tune with the bypass check:
+// measure the null solution, then the stored solution for this frequency.
+// If either is good enough the tune finishes without a search
+//
+void StartFullTune(void)
+{
+  GAlgState = eAlgBypass;
+  GBypassProbe = 0;
+  SetNullSolution();
+  GCurrentSetting.LValue = GetInductance();
+  GCurrentSetting.CValue = GetCapacitance();
+  GCurrentSetting.HighZ = GetHiLoZ();
+}
+
+
+
+//
+// true if a solution is already in the neighbour list, or is the current setting
+//
+bool IsKnownNeighbour(byte L, byte C, bool HighZ)
+{
+  byte Cntr;
+
+  if((L == GCurrentSetting.LValue) && (C == GCurrentSetting.CValue) && (HighZ == GCurrentSetting.HighZ))
+    return true;
+  for(Cntr = 0; Cntr < GNumNeighbours; Cntr++)
+    if((L == GNeighbours[Cntr].LValue) && (C == GNeighbours[Cntr].CValue) && (HighZ == GNeighbours[Cntr].HighZ))
+      return true;
+  return false;
+}
+
+
+//
+// add a stored solution to the neighbour list, if it is new and there is room
+//
+void AddNeighbour(int Frequency10)
+{
+  SResult* Ptr;
+  byte L, C;
+  bool HighZ;
+
+  if((GNumNeighbours < VMAXNEIGHBOURS) && GetStoredSolution(Frequency10, &L, &C, &HighZ) && !IsKnownNeighbour(L, C, HighZ))
+  {
+    Ptr = GNeighbours + GNumNeighbours++;
+    Ptr -> LValue = L;
+    Ptr -> CValue = C;
+    Ptr -> HighZ = HighZ;
+  }
+}
+
+
+//
+// start a quick tune.
+// first measure the current solution, then (one relay step each) up to VMAXNEIGHBOURS distinct
+// stored solutions, stepping out from the tuned frequency: start, +1, -1, +2, -2...
+// the strategy's quick tune then searches around the best of them.
+//
+void StartQuickTune(void)
+{
+  int Offset;
+
+  GCurrentSetting.LValue = GetInductance();
+  GCurrentSetting.CValue = GetCapacitance();
+  GCurrentSetting.HighZ = GetHiLoZ();
+  GNumNeighbours = 0;
+  GNextNeighbour = 0;
+  for(Offset = 0; (Offset <= VNEIGHBOURSEARCH) && (GNumNeighbours < VMAXNEIGHBOURS); Offset++)
+  {
+    AddNeighbour((int)GTunedFrequency10 + Offset);
+    if(Offset != 0)
+      AddNeighbour((int)GTunedFrequency10 - Offset);
+  }
+  if(GNumNeighbours == 0)
+    GActiveStrategy -> Initialise(true);
+  else
+    GAlgState = eAlgNeighbour;
+}
+
+
+//
+// quick tune neighbour step, after the current setting has been measured
+// (the sequencer has already kept it in GBestFoundSoFar if it is the best)
+// try the next stored solution; when all are measured (or one is good enough),
+// load the best into the hardware settings and start the strategy's quick tune from it
+//
+void NeighbourStep(void)
+{
+  if((GNextNeighbour < GNumNeighbours) && (GBestFoundSoFar.VSWR >= VSUCCESSQUICKVSWR))
+  {
+    GCurrentSetting = GNeighbours[GNextNeighbour++];
+    return;
+  }
+#ifdef CONDITIONAL_ALG_DEBUG
+  strcpy(DebugText, "Neighbour check: best found: ");
+  PrintSolution(false);
+#endif
+  SetInductance(GBestFoundSoFar.LValue);                              // driven by the sequencer after the strategy's first step
+  SetCapacitance(GBestFoundSoFar.CValue);
+  SetHiLoZ(GBestFoundSoFar.HighZ);
+  GActiveStrategy -> Initialise(true);
+}
+
+
+
 // there are 4 possible outcomes:
 // 1. full tune, successful: cancel tuning, store best solution & success report
 // 2. full tune, but not successful. cancel tuning, store best solution & set failure report
@@ -449,6 +937,7 @@ void AssessTune(void)
       GAlgState = eAlgEEPROMWrite;
       SendCandidateSolution(false);
       SetTuneResult(true, GBestFoundSoFar.LValue, GBestFoundSoFar.CValue, GBestFoundSoFar.HighZ);
+      TraceEndTune(VTRACERESULTSUCCESS);
 #ifdef CONDITIONAL_ALG_DEBUG
       strcpy(DebugText, "Full tune: successful best found: ");
       PrintSolution(false);                               // print best solution to serial port
@@ -459,6 +948,7 @@ void AssessTune(void)
       GAlgState = eAlgEEPROMWrite;
       SendCandidateSolution(false);
       SetTuneResult(false, GBestFoundSoFar.LValue, GBestFoundSoFar.CValue, GBestFoundSoFar.HighZ);    // sends fail message and writes "no solution"
+      TraceEndTune(VTRACERESULTFAIL);
   #ifdef CONDITIONAL_ALG_DEBUG
       strcpy(DebugText, "Full tune FAIL: unsuccessful best found: ");
       PrintSolution(false);                               // print best solution to serial port
@@ -474,6 +964,7 @@ void AssessTune(void)
     GAlgState = eAlgEEPROMWrite;
     SendCandidateSolution(false);
     SetTuneResult(true, GBestFoundSoFar.LValue, GBestFoundSoFar.CValue, GBestFoundSoFar.HighZ);
+    TraceEndTune(VTRACERESULTSUCCESS);
 #ifdef CONDITIONAL_ALG_DEBUG
     strcpy(DebugText, "Quick tune: successful best found: ");
     PrintSolution(false);                                 // print best solution to serial port
@@ -484,15 +975,44 @@ void AssessTune(void)
 #ifdef CONDITIONAL_ALG_DEBUG
     Serial.println("Quick tune: no solution found ");               
 #endif
-// for full tune: set L=0; Step C=0-255 at coarse step
     GIsQuickTune = false;                                             // cancel quick tune state
     GBestFoundSoFar.VSWR = VMAXVSWR;                                  // initialise VSWR best value found = worst possible
-    GAlgState = eAlgCoarse1;                                          // set state
+    StartFullTune();                                                  // bypass check, then the full search
+  }
+}
+
+
+
 //
-// copy out the first row of the stage 1 algorithm table
+// bypass check step, with the VSWR measured at the current setting
+// if it is good enough, and was measured with steady power (not forced after a hold),
+// finish the tune: it is in GBestFoundSoFar.
+// otherwise try the stored solution, then start the full search
 //
-    GetStage1Row(true);
-    SendCandidateSolution(true);                                      // drive hardware
+void BypassStep(unsigned int VSWR)
+{
+  byte L, C;
+  bool HighZ;
+
+  if((VSWR < VBYPASSVSWR) && GMeasureGated)
+  {
+#ifdef CONDITIONAL_ALG_DEBUG
+    Serial.println("Bypass check: no search needed");
+#endif
+    AssessTune();
+  }
+  else if((GBypassProbe == 0) && GetStoredSolution(GTunedFrequency10, &L, &C, &HighZ)
+    && ((L != GCurrentSetting.LValue) || (C != GCurrentSetting.CValue) || (HighZ != GCurrentSetting.HighZ)))
+  {
+    GBypassProbe = 1;
+    GCurrentSetting.LValue = L;
+    GCurrentSetting.CValue = C;
+    GCurrentSetting.HighZ = HighZ;
+  }
+  else
+  {
+    GBestFoundSoFar.VSWR = VMAXVSWR;
+    GActiveStrategy -> Initialise(false);                             // start the full search
   }
 }
 
@@ -563,196 +1083,134 @@ void SetupNextSweep(byte SweepRange)
 
 
 //
-// function algorithm code periodic tick
+// true if two results are in the same region (same Z, and L and C within the mid stage search range)
+// the mid stage would find one from the other, so it isn't worth keeping both as candidates
 //
-void AlgorithmTick(void)
+bool IsSameRegion(SResult* Result1, SResult* Result2)
 {
-  bool ValidNewRow;                                     // true if new stage 1 row available
-  bool ValidNewStep = false;                            // set true if not yet time to move onto next step
-  byte SweepRange;                                      // sweep range
-  char Str[10];
+  int Range = GTuneParamArray[GFreqRow].Stage2MidRange;
+
+  return (Result1 -> HighZ == Result2 -> HighZ) && 
+         (abs((int)Result1 -> LValue - (int)Result2 -> LValue) <= Range) &&
+         (abs((int)Result1 -> CValue - (int)Result2 -> CValue) <= Range);
+}
+
 
 //
-// only execute algorithm code every few ticks
-// when algorithm starts, reset this to max!
+// add the current setting to the candidate list if it is good enough
+// if a candidate in the same region exists, it replaces it if better;
+// otherwise it goes in the list if the list isn't full, or it is better than the worst.
+// the list is kept in order, best first
 //
-  if(GPCTuneActive && GPTTPressed)
-    InitiateTune(GQuickTuneEnabled);
-  else if (--GAlgTickCount <= 0)
+void AddCandidate(void)
+{
+  SResult New;
+  byte Cntr;
+  byte Position;
+
+  New = GCurrentSetting;
+  New.IsSweepingL = GCurrentSweep.IsSweepingL;
+//
+// find an entry to replace: same region, else the end of the list
+//
+  for(Position = 0; Position < GNumCandidates; Position++)
+    if(IsSameRegion(&New, GCandidates + Position))
+      break;
+  if(Position < GNumCandidates)                    // same region: replace if better
   {
-    GAlgTickCount = VALGTICKSPERSTEP;
+    if(New.VSWR >= GCandidates[Position].VSWR)
+      return;
+  }
+  else if(GNumCandidates < VNUMCANDIDATES)          // list not full: add at end
+    GNumCandidates++;
+  else                                              // replace worst if better
+  {
+    Position = VNUMCANDIDATES-1;
+    if(New.VSWR >= GCandidates[Position].VSWR)
+      return;
+  }
+//
+// insert it, moving better entries down
+//
+  for(Cntr = Position; (Cntr > 0) && (GCandidates[Cntr-1].VSWR > New.VSWR); Cntr--)
+    GCandidates[Cntr] = GCandidates[Cntr-1];
+  GCandidates[Cntr] = New;
+}
+
 
 //
-// see if terminated mid-tune by the PC
+// candidate refinement finished: move on to the next candidate if the result isn't good enough.
+// returns true if the mid stage has been set up for the next candidate
+// when there are no more to try, the best refined result is put back as best found
 //
-    if((GTuneActive == false) && (GAlgState != eAlgIdle))
-    {
-      GAlgState = eAlgIdle;
-    }
-  
+bool TryNextCandidate(void)
+{
+  if(GBestFoundSoFar.VSWR < GRefinedBest.VSWR)
+    GRefinedBest = GBestFoundSoFar;
+  while((GRefinedBest.VSWR >= VSUCCESSVSWR) && (GNextCandidate < GNumCandidates))
+  {
+    GBestFoundSoFar = GCandidates[GNextCandidate++];
+    if(IsSameRegion(&GBestFoundSoFar, &GRefinedBest))                   // already refined this one
+      continue;
+#ifdef CONDITIONAL_ALG_DEBUG
+    strcpy(DebugText, "Refine next candidate: ");
+    PrintSolution(false);
+#endif
+    GAlgState = eAlgMid1;
+    GCurrentSweep.IsHighZ = GBestFoundSoFar.HighZ;
+    GCurrentSweep.IsSweepingL = !GBestFoundSoFar.IsSweepingL;           // sweep the parameter that was fixed
+    GCurrentSweep.StepSize = GTuneParamArray[GFreqRow].Stage2MidStep;
+    SetupNextSweep(GTuneParamArray[GFreqRow].Stage2MidRange);
+    return true;
+  }
+  GBestFoundSoFar = GRefinedBest;
+  return false;
+}
+
+
 //
-// if executing algorithm, get VSWR and store if better than last
-// then try advance to new step
+// table driven strategy: classify then start the coarse stage
+// for full tune: set L=0; Step C=0-255 at coarse step
 //
-    if ((GAlgState != eAlgIdle) && (GAlgState != eAlgEEPROMWrite))
-    {
-      GCurrentSetting.VSWR = GetVSWR();
-      if (GCurrentSetting.VSWR < GBestFoundSoFar.VSWR)
-      {
-        GBestFoundSoFar = GCurrentSetting;
-        GBestFoundSoFar.IsSweepingL = GCurrentSweep.IsSweepingL;
-      }
-  #ifdef CONDITIONAL_ALG_DEBUG
-      strcpy(DebugText, StateNames[(byte)GAlgState]);
-      if(GAlgState == eAlgCoarse1)
-      {
-        mysprintf(Str, GStage1Row, false);
-        strcat(DebugText, Str);
-        strcat(DebugText, ": ");
-      }
-      PrintSolution(true);                // print current step and its VSWR
-  #endif
-  //
-  // now work out proposed next step (if state changes, this may be overridden)
-  //
-      ValidNewStep = FindNextStep();
-    }
-  
-  //
-  // now see what the sequencer tells us to do next!
-  // in most cases, nothing more if ValidNewStep == true
-  //
-    switch(GAlgState)
-    {
-      case eAlgIdle:                                    // do nothing in idle!
-        break;
-  
-      case eAlgCoarse1: 
-        if(!ValidNewStep)                               // if we have exhausted current search, try new row
-        {
-          ValidNewRow = GetStage1Row(false);            // try move to next row. 
-          if(!ValidNewRow)                              // if this fails, change state
-          {
-            // we need to construct a sweep set for stage 1b
-            GAlgState = eAlgCoarse2;
-            GCurrentSweep.IsHighZ = GBestFoundSoFar.HighZ;                  // copy best Z setting
-            GCurrentSweep.IsSweepingL = !GBestFoundSoFar.IsSweepingL;       // opposite sweep needed now
-            GCurrentSweep.StepSize = GTuneParamArray[GFreqRow].Stage1bStep;
-            if(GCurrentSweep.IsSweepingL)
-            {
-              GCurrentSweep.MinSteppedValue = 0;                            // stage 1b will start at 0
-              GCurrentSweep.MaxSteppedValue = GTuneParamArray[GFreqRow].LMax;
-              GCurrentSweep.FixedParam = GBestFoundSoFar.CValue;            // if we now sweep L, copy C value from best so far
-            }
-            else
-            {
-              GCurrentSweep.MinSteppedValue = 0;                            // stage 1b will start at 0
-              GCurrentSweep.MaxSteppedValue = GTuneParamArray[GFreqRow].CMax;
-              GCurrentSweep.FixedParam = GBestFoundSoFar.LValue;            // if we now sweep C, copy L value from best so far
-            }
-            InitialiseCurrentFromSweep();                                   // will be sent to h/w at the end
-          }
-        }
-        break;
-  
-      case eAlgCoarse2:
-        if(!ValidNewStep)                                                   // take best found and set up mid sweep
-        {
-          // we need to construct a sweep set for stage 2 1st mid sweep; keep the Z setting
-          GAlgState = eAlgMid1;
-          GCurrentSweep.IsSweepingL = !GCurrentSweep.IsSweepingL;           // opposite sweep needed now
-          GCurrentSweep.StepSize = GTuneParamArray[GFreqRow].Stage2MidStep;
-          SweepRange = GTuneParamArray[GFreqRow].Stage2MidRange;
-          SetupNextSweep(SweepRange);                                       // set sweep range parameters
-        }
-        break;
-  
-      case eAlgMid1:
-        if(!ValidNewStep)                                                   // take best found and set up 2nd mid sweep
-        {
-          // we need to construct a sweep set for stage 2 1st mid sweep; keep the Z setting
-          GAlgState = eAlgMid2;
-          GCurrentSweep.IsSweepingL = !GCurrentSweep.IsSweepingL;           // opposite sweep needed now
-          GCurrentSweep.StepSize = GTuneParamArray[GFreqRow].Stage2MidStep;
-          SweepRange = GTuneParamArray[GFreqRow].Stage2MidRange;
-          SetupNextSweep(SweepRange);                                       // set sweep range parameters
-        }
-        break;
-  
-      case eAlgMid2:
-        if(!ValidNewStep)                                                   // take best found and set up fine sweep
-        {
-          // we need to construct a sweep set for stage 2 1st mid sweep; keep the Z setting
-          GAlgState = eAlgFine1;
-          GCurrentSweep.IsSweepingL = !GCurrentSweep.IsSweepingL;           // opposite sweep needed now
-          GCurrentSweep.StepSize = 1;
-          SweepRange = GTuneParamArray[GFreqRow].Stage2FineRange;
-          SetupNextSweep(SweepRange);                                       // set sweep range parameters
-        }
-        break;
-  
-      case eAlgFine1: 
-        if(!ValidNewStep)                                                   // take best found and set up 2nd fine sweep
-        {
-          // we need to construct a sweep set for stage 2 1st mid sweep; keep the Z setting
-          GAlgState = eAlgFine2;
-          GCurrentSweep.IsSweepingL = !GCurrentSweep.IsSweepingL;           // opposite sweep needed now
-          GCurrentSweep.StepSize = 1;
-          SweepRange = GTuneParamArray[GFreqRow].Stage2FineRange;
-          SetupNextSweep(SweepRange);                                       // set sweep range parameters
-        }
-        break;
-  
-      case eAlgFine2:
-        if(!ValidNewStep)                                                   // finished final stage
-          AssessTune();
-        break;
-  
-      case eAlgEEPROMWrite:
-        GAlgState = eAlgIdle;                         // finished calculating
-        GTuneActive = false;
-        break;
-    }
-  //
-  // finally send L,C, low/high Z switch setting to hardware if we are in a search state
-  //  
-    if ((GAlgState != eAlgIdle) && (GAlgState != eAlgEEPROMWrite))
-      SendCandidateSolution(true);
-  }
+void StartCoarseStage(void)
+{
+  ClassifyTopology();
+  GAlgState = eAlgCoarse1;                                          // set state
+//
+// copy out the first row of the stage 1 algorithm table
+//
+  GetStage1Row(true);
 }
 
 
-
-
 //
-// cancel algorithm
+// table driven strategy: store the probe measurement, and find the next probe
+// after the last, start the model solve; AlgorithmTick runs it over the next few ticks,
+// then the setting is measured again and the coarse stage is started
 //
-void CancelAlgorithm(void)
+bool ClassifyStep(unsigned int VSWR)
 {
-  GTuneActive = false;
-  GAlgState = eAlgIdle;
+  AddProbeMeasurement(GCurrentSetting.LValue, GCurrentSetting.CValue, GCurrentSetting.HighZ, VSWR);
+  if(!GetProbeSetting(GetNumProbeMeasurements(), GTuneParamArray[GFreqRow].LMax, GTuneParamArray[GFreqRow].CMax, 
+                      &GCurrentSetting.LValue, &GCurrentSetting.CValue, &GCurrentSetting.HighZ)
+     && !StartModelSolve(GTuneParamArray[GFreqRow].LMax, GTuneParamArray[GFreqRow].CMax))
+    StartCoarseStage();
+  return true;
 }
 
 
 
 //
-// function to initiate a tune algorithm sequence - beginning with a quick tune
-// this initialises the data structures so that a series of timer ticks will step through the cycle
-// At the moment, this is always called with a quick tune first.
-// the frequency will already have been set/
-//
+// table driven strategy: set up the first candidate
 // for quick tune: set to state fine 1, sweeping L according to sweep range in frequency dependent algorithm table
-//
 // for full tune: set 1st sweep of the stage 1 parameter table
 //
-void InitiateTune(bool StartQuick)
+void TableInitialise(bool StartQuick)
 {
-  bool GotRow;                                          // true if found 1st row of algorithm
-  byte SweepRange;                                           // tune range
+  byte SweepRange;                                      // tune range
 
   if (StartQuick)
   {
-    GIsQuickTune = true;                                // set "this is a quick tune attempt"
     GAlgState = eAlgFine1;                              // set state
 //
 // create the sweep definition; sweep L first
@@ -771,18 +1229,655 @@ void InitiateTune(bool StartQuick)
   }
   else                                                                // start a normal full tune
   {
-// for full tune: set L=0; Step C=0-255 at coarse step
-    GIsQuickTune = false;                                             // cancel quick tune state
-    GAlgState = eAlgCoarse1;                                          // set state
 //
-// copy out the first row of the stage 1 algorithm table
+// first classify the load as high or low Z. Use the probe measurements the model needs
+// (unless they have already been made); then set up the coarse stage
+//
+    GZCommitted = false;
+    GOtherZTried = false;
+    GAlgState = eAlgClassify;
+    if(!GetProbeSetting(GetNumProbeMeasurements(), GTuneParamArray[GFreqRow].LMax, GTuneParamArray[GFreqRow].CMax, 
+                        &GCurrentSetting.LValue, &GCurrentSetting.CValue, &GCurrentSetting.HighZ)
+       && !StartModelSolve(GTuneParamArray[GFreqRow].LMax, GTuneParamArray[GFreqRow].CMax))
+      StartCoarseStage();
+  }
+}
+
+
+//
+// table driven strategy: find the next candidate
+// steps through the current sweep, then the sequencer moves on to the next sweep
+// returns false when the final fine sweep is complete
+//
+bool TableStep(unsigned int VSWR)
+{
+  bool Result = true;                                   // true if a new candidate set
+  bool ValidNewRow;                                     // true if new stage 1 row available
+  bool ValidNewStep;                                    // set true if not yet time to move onto next step
+  byte SweepRange;                                      // sweep range
+
+  if(GAlgState == eAlgClassify)
+    return ClassifyStep(VSWR);
+  if((GAlgState == eAlgCoarse1) || (GAlgState == eAlgCoarse2))
+    AddCandidate();
+//
+// work out proposed next step (if state changes, this may be overridden)
+//
+  ValidNewStep = FindNextStep();
+//
+// now see what the sequencer tells us to do next!
+// in most cases, nothing more if ValidNewStep == true
+//
+  switch(GAlgState)
+  {
+    case eAlgCoarse1: 
+      if(!ValidNewStep)                               // if we have exhausted current search, try new row
+      {
+        ValidNewRow = GetStage1Row(false);            // try move to next row. 
+        if(!ValidNewRow)                              // if this fails, change state
+        {
+          // we need to construct a sweep set for stage 1b
+          GAlgState = eAlgCoarse2;
+          GCurrentSweep.IsHighZ = GBestFoundSoFar.HighZ;                  // copy best Z setting
+          GCurrentSweep.IsSweepingL = !GBestFoundSoFar.IsSweepingL;       // opposite sweep needed now
+          GCurrentSweep.StepSize = GTuneParamArray[GFreqRow].Stage1bStep;
+          if(GCurrentSweep.IsSweepingL)
+          {
+            GCurrentSweep.MinSteppedValue = 0;                            // stage 1b will start at 0
+            GCurrentSweep.MaxSteppedValue = GTuneParamArray[GFreqRow].LMax;
+            GCurrentSweep.FixedParam = GBestFoundSoFar.CValue;            // if we now sweep L, copy C value from best so far
+          }
+          else
+          {
+            GCurrentSweep.MinSteppedValue = 0;                            // stage 1b will start at 0
+            GCurrentSweep.MaxSteppedValue = GTuneParamArray[GFreqRow].CMax;
+            GCurrentSweep.FixedParam = GBestFoundSoFar.LValue;            // if we now sweep C, copy L value from best so far
+          }
+          InitialiseCurrentFromSweep();                                   // will be sent to h/w at the end
+        }
+      }
+      break;
+
+    case eAlgCoarse2:
+      if(!ValidNewStep)                                                   // take best found and set up mid sweep
+      {
+        // we need to construct a sweep set for stage 2 1st mid sweep; keep the Z setting
+        // the best found is refined first: skip its entry in the candidate list
+        if((GNumCandidates != 0) && IsSameRegion(GCandidates, &GBestFoundSoFar))
+          GNextCandidate = 1;
+        GAlgState = eAlgMid1;
+        GCurrentSweep.IsSweepingL = !GCurrentSweep.IsSweepingL;           // opposite sweep needed now
+        GCurrentSweep.StepSize = GTuneParamArray[GFreqRow].Stage2MidStep;
+        SweepRange = GTuneParamArray[GFreqRow].Stage2MidRange;
+        SetupNextSweep(SweepRange);                                       // set sweep range parameters
+      }
+      break;
+
+    case eAlgMid1:
+      if(!ValidNewStep)                                                   // take best found and set up 2nd mid sweep
+      {
+        // we need to construct a sweep set for stage 2 1st mid sweep; keep the Z setting
+        GAlgState = eAlgMid2;
+        GCurrentSweep.IsSweepingL = !GCurrentSweep.IsSweepingL;           // opposite sweep needed now
+        GCurrentSweep.StepSize = GTuneParamArray[GFreqRow].Stage2MidStep;
+        SweepRange = GTuneParamArray[GFreqRow].Stage2MidRange;
+        SetupNextSweep(SweepRange);                                       // set sweep range parameters
+      }
+      break;
+
+    case eAlgMid2:
+      if(!ValidNewStep)                                                   // take best found and set up fine sweep
+      {
+        // we need to construct a sweep set for stage 2 1st mid sweep; keep the Z setting
+        GAlgState = eAlgFine1;
+        GCurrentSweep.IsSweepingL = !GCurrentSweep.IsSweepingL;           // opposite sweep needed now
+        GCurrentSweep.StepSize = 1;
+        SweepRange = GTuneParamArray[GFreqRow].Stage2FineRange;
+        SetupNextSweep(SweepRange);                                       // set sweep range parameters
+      }
+      break;
+
+    case eAlgFine1: 
+      if(!ValidNewStep)                                                   // take best found and set up 2nd fine sweep
+      {
+        // we need to construct a sweep set for stage 2 1st mid sweep; keep the Z setting
+        GAlgState = eAlgFine2;
+        GCurrentSweep.IsSweepingL = !GCurrentSweep.IsSweepingL;           // opposite sweep needed now
+        GCurrentSweep.StepSize = 1;
+        SweepRange = GTuneParamArray[GFreqRow].Stage2FineRange;
+        SetupNextSweep(SweepRange);                                       // set sweep range parameters
+      }
+      break;
+
+    case eAlgFine2:
+      if(!ValidNewStep)                                                   // finished final stage
+        Result = TryNextCandidate() || TryOtherTopology();
+      break;
+
+    default:
+      break;
+  }
+  return Result;
+}
+
+
+//
+// the table driven strategy
+// a full tune classifies the load as high or low Z (from the model probes and stored solutions),
+// then runs the stage 1 table sweeps for the committed Z setting, then the fine sweeps
+//
+const STuneStrategy GTableStrategy = 
+{
+  "Table", TableInitialise, TableStep
+};
+
+
+
+//
+// pattern search strategy: as the table driven strategy, but the two fine sweeps
+// are replaced by a 2D pattern search, which also makes diagonal moves.
+// the pattern search starts from the best found, at half the mid step size.
+// quick tune is a pattern search around the current hardware solution.
+//
+void PatternInitialise(bool StartQuick)
+{
+  byte Step;
+
+  if (StartQuick)
+  {
+    GAlgState = eAlgPattern;
+    Step = max(GTuneParamArray[GFreqRow].Stage2FineRange >> 2, 1);
+    GCurrentSetting.HighZ = GetHiLoZ();
+    GCurrentSweep.IsSweepingL = true;
+    PatternSearchStart(GetInductance(), GetCapacitance(), PATTERNNOTMEASURED, 
+                       GTuneParamArray[GFreqRow].LMax, GTuneParamArray[GFreqRow].CMax, Step, GTuneParamArray[GFreqRow].Stage2FineRange);
+    GCurrentSetting.LValue = GPatternL;
+    GCurrentSetting.CValue = GPatternC;
+  }
+  else
+    TableInitialise(false);
+}
+
+
+//
+// pattern search strategy: find the next candidate
+// the table strategy runs until it would start the fine sweeps
+//
+bool PatternStep(unsigned int VSWR)
+{
+  bool Result;
+  byte Step;
+
+  if (GAlgState != eAlgPattern)
+  {
+    Result = TableStep(VSWR);
+    if (GAlgState != eAlgFine1)                                       // table has not reached the fine stage yet
+      return Result;
+
+    GAlgState = eAlgPattern;
+    Step = max(GTuneParamArray[GFreqRow].Stage2MidStep >> 1, 1);
+    GCurrentSetting.HighZ = GBestFoundSoFar.HighZ;
+    Result = PatternSearchStart(GBestFoundSoFar.LValue, GBestFoundSoFar.CValue, GBestFoundSoFar.VSWR,
+                                GTuneParamArray[GFreqRow].LMax, GTuneParamArray[GFreqRow].CMax, Step, GTuneParamArray[GFreqRow].Stage2FineRange);
+  }
+  else
+    Result = PatternSearchStep(VSWR);
+
+  if(!Result && !GIsQuickTune && (TryNextCandidate() || TryOtherTopology()))   // refine next candidate or search other Z setting
+    return true;
+  GCurrentSetting.LValue = GPatternL;
+  GCurrentSetting.CValue = GPatternC;
+  return Result;
+}
+
+
+//
+// the pattern search strategy
+//
+const STuneStrategy GPatternStrategy = 
+{
+  "Pattern", PatternInitialise, PatternStep
+};
+
+
+
+//
+// model strategy: set up the first candidate
+// quick tune is the same as the pattern search strategy
+// full tune measures VSWR at a few probe settings, from which the model calculates a solution.
+// if no frequency is known, the model can't be used: use the pattern search strategy instead.
+//
+void ModelInitialise(bool StartQuick)
+{
+  GModelFallback = false;
+  GProbeNumber = 0;
+  if (StartQuick)
+    PatternInitialise(true);
+  else if (GetProbeSetting(0, GTuneParamArray[GFreqRow].LMax, GTuneParamArray[GFreqRow].CMax, 
+                           &GCurrentSetting.LValue, &GCurrentSetting.CValue, &GCurrentSetting.HighZ))
+    GAlgState = eAlgProbe;
+  else
+  {
+    GModelFallback = true;
+    PatternInitialise(false);
+  }
+}
+
+
+//
+// model strategy: find the next candidate
+// after the last probe, drive the model solution then polish it with a short pattern search.
+// if the result isn't good enough for a successful tune, fall back to the pattern search strategy
+// (the best found so far is kept)
+//
+bool ModelStep(unsigned int VSWR)
+{
+  if (GModelFallback)
+    return PatternStep(VSWR);
+
+  if (GAlgState == eAlgProbe)
+  {
+    AddProbeMeasurement(GCurrentSetting.LValue, GCurrentSetting.CValue, GCurrentSetting.HighZ, VSWR);
+    GProbeNumber++;
+    if (GetProbeSetting(GProbeNumber, GTuneParamArray[GFreqRow].LMax, GTuneParamArray[GFreqRow].CMax,
+                        &GCurrentSetting.LValue, &GCurrentSetting.CValue, &GCurrentSetting.HighZ))
+      return true;
+//
+// all probes measured: calculate the solution (AlgorithmTick runs the solve over the next
+// few ticks, then this is called again), then pattern search from there (it is measured first)
+//
+    if (StartModelSolve(GTuneParamArray[GFreqRow].LMax, GTuneParamArray[GFreqRow].CMax))
+      return true;
+    FindModelSolution(&GCurrentSetting.LValue, &GCurrentSetting.CValue, &GCurrentSetting.HighZ);
+    GAlgState = eAlgPattern;
+    GCurrentSweep.IsSweepingL = true;
+    return PatternSearchStart(GCurrentSetting.LValue, GCurrentSetting.CValue, PATTERNNOTMEASURED,
+                              GTuneParamArray[GFreqRow].LMax, GTuneParamArray[GFreqRow].CMax, 1, 4);
+  }
+
+  if (PatternSearchStep(VSWR))
+  {
+    GCurrentSetting.LValue = GPatternL;
+    GCurrentSetting.CValue = GPatternC;
+    return true;
+  }
+  else if (GBestFoundSoFar.VSWR >= VSUCCESSVSWR)
+  {
+#ifdef CONDITIONAL_ALG_DEBUG
+    Serial.println("Model solution not good enough: search");
+#endif
+    GModelFallback = true;
+    PatternInitialise(false);
+    return true;
+  }
+  return false;
+}
+
+
+//
+// the model strategy
+//
+const STuneStrategy GModelStrategy = 
+{
+  "Model", ModelInitialise, ModelStep
+};
+
+
+
+//
+// log reactance strategy: set up the first candidate
+// quick tune is the same as the pattern search strategy.
+// full tune measures a grid of L and C settings in equal steps of log reactance at the tuned frequency,
+// for both Z settings; if no frequency is known use the pattern search strategy instead.
+//
+void LogGridInitialise(bool StartQuick)
+{
+  if (StartQuick)
+  {
+    PatternInitialise(true);
+    return;
+  }
+  GNumLogL = GetLogReactanceSteps(true, GTuneParamArray[GFreqRow].LMax, GLogLCodes, VMAXLOGSTEPS);
+  GNumLogC = GetLogReactanceSteps(false, GTuneParamArray[GFreqRow].CMax, GLogCCodes, VMAXLOGSTEPS);
+  if ((GNumLogL == 0) || (GNumLogC == 0))
+  {
+    PatternInitialise(false);
+    return;
+  }
+  GAlgState = eAlgLogGrid;
+  GLogLIndex = 0;
+  GLogCIndex = 0;
+  GLogBestLIndex = 0;
+  GLogBestCIndex = 0;
+  GCurrentSweep.IsSweepingL = true;
+  GCurrentSetting.HighZ = false;
+  GCurrentSetting.LValue = GLogLCodes[0];
+  GCurrentSetting.CValue = GLogCCodes[0];
+}
+
+
+//
+// find pattern search step for a log grid setting: half the smaller gap to its neighbours
+//
+byte GetLogGridStep(byte* Codes, byte NumCodes, byte Index)
+{
+  byte Gap = 255;
+
+  if (Index > 0)
+    Gap = Codes[Index] - Codes[Index-1];
+  if (Index < NumCodes-1)
+    Gap = min(Gap, (byte)(Codes[Index+1] - Codes[Index]));
+  return max(Gap >> 1, 1);
+}
+
+
+//
+// log reactance strategy: find the next candidate
+// step C, then L, then Z across the grid; then pattern search from the best grid point
+//
+bool LogGridStep(unsigned int VSWR)
+{
+  bool Result;
+  byte Step;
+
+  if (GAlgState != eAlgLogGrid)                                   // pattern search, or fallen back to a table search
+    return PatternStep(VSWR);
+
+  if ((GBestFoundSoFar.LValue == GCurrentSetting.LValue) && (GBestFoundSoFar.CValue == GCurrentSetting.CValue)
+    && (GBestFoundSoFar.HighZ == GCurrentSetting.HighZ))
+  {
+    GLogBestLIndex = GLogLIndex;
+    GLogBestCIndex = GLogCIndex;
+  }
+  if (++GLogCIndex >= GNumLogC)
+  {
+    GLogCIndex = 0;
+    if (++GLogLIndex >= GNumLogL)
+    {
+      GLogLIndex = 0;
+      GCurrentSetting.HighZ = !GCurrentSetting.HighZ;
+      if (!GCurrentSetting.HighZ)                                 // both Z settings done: refine the best
+      {
+        GAlgState = eAlgPattern;
+        Step = max(GetLogGridStep(GLogLCodes, GNumLogL, GLogBestLIndex), GetLogGridStep(GLogCCodes, GNumLogC, GLogBestCIndex));
+        GCurrentSetting.HighZ = GBestFoundSoFar.HighZ;
+        Result = PatternSearchStart(GBestFoundSoFar.LValue, GBestFoundSoFar.CValue, GBestFoundSoFar.VSWR,
+                                    GTuneParamArray[GFreqRow].LMax, GTuneParamArray[GFreqRow].CMax, Step, Step << 1);
+        GCurrentSetting.LValue = GPatternL;
+        GCurrentSetting.CValue = GPatternC;
+        return Result;
+      }
+    }
+  }
+  GCurrentSetting.LValue = GLogLCodes[GLogLIndex];
+  GCurrentSetting.CValue = GLogCCodes[GLogCIndex];
+  return true;
+}
+
+
+//
+// the log reactance strategy
+//
+const STuneStrategy GLogGridStrategy = 
+{
+  "LogX", LogGridInitialise, LogGridStep
+};
+
+
+
+//
+// list of the available strategies, selected by GTuneStrategy
+// new strategies are added to the end of this list
+//
+#define VNUMSTRATEGIES 4
+const STuneStrategy* GStrategyList[VNUMSTRATEGIES] =
+{
+  &GTableStrategy,                                      // 0: table driven search (Z classified by the model first)
+  &GPatternStrategy,                                    // 1: table coarse and mid search, then pattern search
+  &GModelStrategy,                                      // 2: probe measurements and L network model, then pattern search
+  &GLogGridStrategy                                     // 3: grid in equal steps of log reactance, then pattern search
+};
+
+
+
+//
+// function algorithm code periodic tick
+//
+void AlgorithmTick(void)
+{
+  GAlgTickStamp++;                                      // timestamp for trace
+  if(GTuneActive)
+    UpdatePowerGate();
+//
+// only execute algorithm code every few ticks
+// when algorithm starts, reset this to max!
+// a tune requested by CAT or the hardwired TUNE input (latched by its ISR) starts here
+//
+  if(GPCTuneActive && GPTTPressed)
+    InitiateTune(GQuickTuneEnabled);
+  else if (--GAlgTickCount <= 0)
+  {
+    GAlgTickCount = VALGTICKSPERSTEP;
+
+//
+// see if terminated mid-tune by the PC
+//
+    if((GTuneActive == false) && (GAlgState != eAlgIdle))
+    {
+      GAlgState = eAlgIdle;
+      TraceEndTune(VTRACERESULTCANCELLED);
+    }
+  
+    if (GAlgState == eAlgEEPROMWrite)
+    {
+      GAlgState = eAlgIdle;                             // finished calculating
+      GTuneActive = false;
+    }
+//
+// if the model is being solved, run the next slice of it; nothing is measured
+//
+    else if ((GAlgState != eAlgIdle) && ModelSolveStep())
+      GAlgTickCount = 1;                                // next slice next tick
+//
+// if executing algorithm, get VSWR and store if better than last
+// then ask the strategy for the next step; when it has finished, assess the result.
+// with no drive the VSWR reading isn't valid (it reads 1.0): never measure. Hold; if the
+// drive doesn't return, cancel the tune (it can be resumed)
+//
+    else if ((GAlgState != eAlgIdle) && (GAveragePower < VMINTUNEPOWER))
+    {
+      GAlgTickCount = 1;                                // hold, and check again next tick
+      if(++GNoPowerTicks >= VMAXNOPOWERTICKS)
+      {
+#ifdef CONDITIONAL_ALG_DEBUG
+        Serial.println("No drive power: tune cancelled");
+#endif
+        CancelAlgorithm();
+      }
+    }
+    else if ((GAlgState != eAlgIdle) && (GPowerStableCount < VPOWERSTABLETICKS) && (GPowerHoldTicks < VMAXPOWERHOLDTICKS))
+    {
+      GAlgTickCount = 1;                                // drive power not steady: hold, and check again next tick
+      GPowerHoldTicks++;
+      GNoPowerTicks = 0;
+    }
+    else if (GAlgState != eAlgIdle)
+    {
+      GMeasureGated = (GPowerStableCount >= VPOWERSTABLETICKS);
+      if(!GMeasureGated)                                // held too long (eg PA foldback): measure, and take a new
+        GTuneRefPower = 0.0F;                           // reference when power is steady again
+      GPowerHoldTicks = 0;                              // the next step is gated again
+      GNoPowerTicks = 0;
+      GCurrentSetting.VSWR = GetVSWR();
+      if (GCurrentSetting.VSWR < GBestFoundSoFar.VSWR)
+      {
+        GBestFoundSoFar = GCurrentSetting;
+        GBestFoundSoFar.IsSweepingL = GCurrentSweep.IsSweepingL;
+      }
+      TraceStep();                                      // record step in tune trace
+      if(GAlgState == eAlgBypass)
+        BypassStep(GCurrentSetting.VSWR);
+      else if(GAlgState == eAlgNeighbour)
+        NeighbourStep();
+      else if(!GActiveStrategy -> Step(GCurrentSetting.VSWR))
+        AssessTune();
+  //
+  // finally send L,C, low/high Z switch setting to hardware if we are in a search state
+  //  
+      if ((GAlgState != eAlgIdle) && (GAlgState != eAlgEEPROMWrite))
+        SendCandidateSolution(true);
+    }
+  }
+}
+
+
+
+
+//
+// cancel algorithm
 //
-    GotRow = GetStage1Row(true);
+void CancelAlgorithm(void)
+{
+  if((GAlgState != eAlgIdle) && (GAlgState != eAlgEEPROMWrite))
+  {
+    GCheckpoint.Valid = true;
+    GCheckpoint.AlgState = GAlgState;
+    GCheckpoint.Stage1Row = GStage1Row;
+    GCheckpoint.CurrentSweep = GCurrentSweep;
+    GCheckpoint.CurrentSetting = GCurrentSetting;
+    GCheckpoint.BestFoundSoFar = GBestFoundSoFar;
+    GCheckpoint.IsQuickTune = GIsQuickTune;
+    GCheckpoint.Strategy = GActiveStrategy;
+    GCheckpoint.Frequency10 = GTunedFrequency10;
+    GCheckpoint.Antenna = GTXAntenna;
+    GCheckpoint.Time = millis();
+  }
+  GTuneActive = false;
+  GAlgState = eAlgIdle;
+  TraceEndTune(VTRACERESULTCANCELLED);
+}
+
+
+//
+// resume a cancelled tune from its checkpoint
+// returns false if it can't be resumed: there isn't one, it is too old,
+// the frequency, antenna or strategy has changed.
+//
+bool ResumeTune(void)
+{
+  bool Result = false;
+
+  if(GCheckpoint.Valid && (GResumeTime != 0) 
+     && ((millis() - GCheckpoint.Time) < (unsigned long)GResumeTime * 1000UL)
+     && (GCheckpoint.Frequency10 == GTunedFrequency10) && (GCheckpoint.Antenna == GTXAntenna)
+     && (GCheckpoint.Strategy == GStrategyList[GTuneStrategy]))
+  {
+    GAlgState = GCheckpoint.AlgState;
+    GStage1Row = GCheckpoint.Stage1Row;
+    GCurrentSweep = GCheckpoint.CurrentSweep;
+    GCurrentSetting = GCheckpoint.CurrentSetting;
+    GBestFoundSoFar = GCheckpoint.BestFoundSoFar;
+    GIsQuickTune = GCheckpoint.IsQuickTune;
+    GActiveStrategy = GCheckpoint.Strategy;
+    Result = true;
+#ifdef CONDITIONAL_ALG_DEBUG
+    strcpy(DebugText, "Resume tune: ");
+    strcat(DebugText, StateNames[(byte)GAlgState]);
+    PrintSolution(false);
+#endif
+  }
+  GCheckpoint.Valid = false;
+  return Result;
+}
+
+
+//
+// set the time (s) for which a cancelled tune can be resumed; 0 = never resume
+//
+void SetResumeTime(byte Seconds)
+{
+  GResumeTime = Seconds;
+}
+
+
+
+//
+// get the current algorithm sequencer state
+// (returned as a number for status reporting; 0 = idle)
+//
+byte GetAlgorithmState(void)
+{
+  return (byte)GAlgState;
+}
+
+
+
+//
+// select the tuning strategy (for the next tune)
+// out of range values select the table driven strategy (strategy 0)
+//
+void SetTuneStrategy(byte Strategy)
+{
+  if(Strategy >= VNUMSTRATEGIES)
+    Strategy = 0;
+  GTuneStrategy = Strategy;
+}
+
+
+//
+// get the number of strategies available, and a strategy name for display
+//
+byte GetNumTuneStrategies(void)
+{
+  return VNUMSTRATEGIES;
+}
+
+const char* GetTuneStrategyName(byte Strategy)
+{
+  if(Strategy >= VNUMSTRATEGIES)
+    Strategy = 0;
+  return GStrategyList[Strategy] -> Name;
+}
+
+
+
+//
+// function to initiate a tune algorithm sequence - beginning with a quick tune
+// this initialises the data structures so that a series of timer ticks will step through the cycle
+// the frequency will already have been set.
+// the selected strategy sets up the first candidate solution
+//
+void InitiateTune(bool StartQuick)
+{
+  bool Resumed;
+
+  Resumed = ResumeTune();                                           // carry on with a cancelled tune if possible
+  if(!Resumed)
+  {
+    GIsQuickTune = StartQuick;                                      // set "this is a quick tune attempt"
+    GZCommitted = false;
+    GOtherZTried = false;
+    GNumCandidates = 0;
+    GRefinedBest.VSWR = VMAXVSWR;
+    SetModelFrequency(GTunedFrequency10);                           // clear model probe measurements
+    GActiveStrategy = GStrategyList[GTuneStrategy];
+    if(StartQuick)
+      StartQuickTune();
+    else
+      StartFullTune();
   }
 
+  TraceEndTune(VTRACERESULTCANCELLED);                              // in case a previous tune was still running
+  TraceStartTune(GIsQuickTune);
+  GTuneRefPower = 0.0F;                                             // new power reference
+  GAveragePower = GForwardWatts;
+  GPowerStableCount = 0;
+  GPowerHoldTicks = 0;
+  GNoPowerTicks = 0;
   GAlgTickCount = VALGSTARTDELAYTICKS;
   GTuneActive = true;                                               // set active
   SendCandidateSolution(true);                                      // drive hardware
-  GBestFoundSoFar.VSWR = VMAXVSWR;                                  // initialise VSWR best value found = worst possible
+  if(!Resumed)
+    GBestFoundSoFar.VSWR = VMAXVSWR;                                // initialise VSWR best value found = worst possible
   GPCTuneActive = false;                                            // cancel CAT tune now we've started
 }
@@ -14,6 +14,8 @@
 
 extern bool GTuneActive;              // bool set true when algorithm running. Clear it to terminate.
 extern bool GQuickTuneEnabled;         // true if quick tune allowed
+extern byte GTuneStrategy;             // selected tuning strategy
+extern byte GResumeTime;               // time (s) a cancelled tune can be resumed for; 0 = never
 
 
 //
@@ -32,9 +34,9 @@ void AlgorithmTick(void);
 //
 // find the frequency row to use
 // sets the row variable for tuning parameters to use
-// paramters is the required frequency (units of MHz)
+// paramters is the required frequency (units of 10KHz)
 // 
-void FindFreqRow(byte FrequencyMHz);
+void FindFreqRow(unsigned int Frequency10);
 
 
 //
@@ -53,9 +55,51 @@ void InitiateTune(bool StartQuick);
 
 //
 // cancel algorithm
+// a tune cancelled part way through is checkpointed, and resumes on the next tune
+// if the frequency and antenna are unchanged and it is recent enough
 //
 void CancelAlgorithm(void);
 
 
+//
+// set the time (s) for which a cancelled tune can be resumed; 0 = never resume
+//
+void SetResumeTime(byte Seconds);
+
+
+//
+// select the tuning strategy used for the next tune
+// out of range values select the table driven strategy (strategy 0)
+//
+void SetTuneStrategy(byte Strategy);
+
+
+//
+// get the number of strategies available, and a strategy name for display
+//
+byte GetNumTuneStrategies(void);
+const char* GetTuneStrategyName(byte Strategy);
+
+
+//
+// start sending the trace of the last few tunes to the PC
+// parameter is the number of tunes to send
+//
+void SendTuneTrace(byte NumTunes);
+
+
+//
+// tick for the tune trace dump: sends the next few trace records
+//
+void TraceDumpTick(void);
+
+
+//
+// get the current algorithm sequencer state
+// (returned as a number for status reporting; 0 = idle)
+//
+byte GetAlgorithmState(void);
+
+
 
 #endif
@@ -134,7 +134,7 @@ void TickHandler(void)
 //
 // 16 ms event loop
 // this is triggered by GTickTriggered being set by a timer interrupt
-// the loop simply waits until released by the timer handler
+// the loop simply waits until released by the timer handler, servicing the display link
 void loop()
 {
   while (GTickTriggered)
@@ -181,6 +181,10 @@ void loop()
 //
     LCD_UI_Tick();
   }   // while loop
+//
+// between ticks: service the display link
+//
+  LCD_UI_Service();
 }
 
 
@@ -22,6 +22,7 @@
 #include "extEEPROM.h"
 #include "hwdriver.h"
 #include "algorithm.h"
+#include "formatter.h"
 
 
 #define VEEDISPLAYPAGELOC 0x1FFF0L
@@ -29,6 +30,9 @@
 #define VEEENABLEDLOC 0x1FFF2L
 #define VEEDISPLAYSCALELOC 0x1FFF3L
 #define VEEALLOWQUICKLOC 0x1FFF4L
+#define VEESTRATEGYLOC 0x1FFF5L
+#define VEERESUMETIMELOC 0x1FFF6L
+#define VEEDISPLAYBAUDLOC 0x1FFF7L
 
 
 
@@ -46,7 +50,7 @@ bool GATUEnabled;                               // true if the ATU is enabled
 unsigned int GQueuedCATFrequency;               // frequency passed by tHETIS if TX was active.
 byte GRXAntenna;                                // selected RX antenna (1-3; 0 if not set)
 byte GTXAntenna;                                // selected TX antenna (1-3; 0 if not set)
-bool GPCTuneActive;                             // true if TUNE is in progress as signalled by PC (note PTT will be detected first)
+volatile bool GPCTuneActive;                    // true if TUNE is in progress as signalled by PC (note PTT will be detected first)
 volatile bool GPTTPressed;                      // true if PTT pressed (ie TX active). Set by interrupt
 volatile bool GTuneHWPressed;                   // true if tune strobe active (ie tune request). Set by interrupt
 unsigned int GSolutionStartFreq;                // start frequency for internal block of stored solutions
@@ -57,10 +61,14 @@ byte GPTTReleaseCount;                          // PTT release counter, for debo
 byte GTuneHWReleaseCount;                       // hardwired tune strobe release counter
 bool GValidSolution;                            // true if a valid tune solution found
 unsigned int GFreqPollTicks;                    // period in ticks until next frequency poll
+unsigned int GStatusReportTicks;                // status report interval in ticks; 0 if not subscribed
+unsigned int GStatusReportCountdown;            // ticks until next status report
 
 
 #define VFULLTUNEFREQ 1000                      // freq (10KHz units) above which we always full tune
 #define VFREQPOLLINTERVAL 312                   // units of ticks. 5s between freq polls
+#define VMSPERTICK 16                           // main tick period, ms
+#define VSTATUSMSGLENGTH 26                     // number of characters in a status message parameter
 
 // buffer to hold a set of solutions for all HF frequencies for one antenna
 // chosen to be an integer number of EEPROM pages, slightly larger than max size needed
@@ -89,6 +97,8 @@ int GLocalSearch[] =
 //
 void InitCATHandler(void)
 {
+  byte Setting;
+
   byte i2cStat = myEEPROM.begin(myEEPROM.twiClock400kHz);
 //  if ( i2cStat != 0 ) 
 //  {
@@ -102,6 +112,10 @@ void InitCATHandler(void)
     GATUEnabled = EEReadEnabled();
     GQuickTuneEnabled = EEReadQuick();
   }
+  SetTuneStrategy(EEReadStrategy());          // strategy is not set by the PC's ATU settings, so always load
+  Setting = EEReadResumeTime();
+  if(Setting != 0xFF)                         // if not uninitialised, load resume time
+    SetResumeTime(Setting);
 }
 
 
@@ -166,6 +180,32 @@ void MakeEraseSuccessMessage(bool Result)
 }
 
 
+//
+// function to send back an ATU status message
+// this batches everything the PC needs to know into one fixed width reply:
+// LLL CCC Z VVVVV PPPP III SS A FFFF (no spaces)
+// L, C = 0-255; Z = 1 if high Z; V = 100*VSWR; P = forward power (W);
+// I = PA current (0.1A units); S = algorithm state; A = TX antenna; F = frequency (10KHz units)
+//
+void MakeStatusMessage(void)
+{
+  char Str[VSTATUSMSGLENGTH+1];
+  SFormatter Fmt;
+
+  FormatBegin(&Fmt, Str, sizeof(Str));
+  FormatField(&Fmt, GetInductance(), 3);
+  FormatField(&Fmt, GetCapacitance(), 3);
+  FormatField(&Fmt, GetHiLoZ(), 1);
+  FormatField(&Fmt, (long)(GVSWR * 100.0), 5);
+  FormatField(&Fmt, GetPowerReading(true), 4);
+  FormatField(&Fmt, GPACurrent, 3);
+  FormatField(&Fmt, GetAlgorithmState(), 2);
+  FormatField(&Fmt, GTXAntenna, 1);
+  FormatField(&Fmt, GTunedFrequency10, 4);
+  MakeCATMessageString(eZZOS, Str);
+}
+
+
 
 //////////////////////// EEPROM access functions //////////////////////////////////////
 
@@ -379,18 +419,94 @@ bool EEReadQuick()
 }
 
 
+//
+// function to write, read tuning strategy selection
+// (uninitialised EEPROM reads 0xFF, which selects the default strategy)
+//
+void EEWriteStrategy(byte Value)
+{
+  myEEPROM.write(VEESTRATEGYLOC, Value);
+}
+
+byte EEReadStrategy()
+{
+  byte Result;
+  Result = myEEPROM.read(VEESTRATEGYLOC);
+  return Result;
+}
+
+
+//
+// function to write, read cancelled tune resume time (s)
+// (uninitialised EEPROM reads 0xFF: the default time is then used)
+//
+void EEWriteResumeTime(byte Value)
+{
+  myEEPROM.write(VEERESUMETIMELOC, Value);
+}
+
+byte EEReadResumeTime()
+{
+  byte Result;
+  Result = myEEPROM.read(VEERESUMETIMELOC);
+  return Result;
+}
+
+
+//
+// function to write, read display link baud rate (index into the LCD_UI rate table)
+// (uninitialised EEPROM reads 0xFF: the rate is then negotiated from the fastest)
+//
+void EEWriteDisplayBaud(byte Value)
+{
+  myEEPROM.write(VEEDISPLAYBAUDLOC, Value);
+}
+
+byte EEReadDisplayBaud()
+{
+  byte Result;
+  Result = myEEPROM.read(VEEDISPLAYBAUDLOC);
+  return Result;
+}
+
+
 
 ///////////////////////////////// process CAT commands ///////////////////////
 
+//
+// get the stored solution for a frequency, for the current antenna
+// returns false if there is no valid solution stored
+//
+bool GetStoredSolution(int Frequency10, byte* L, byte* C, bool* HighZ)
+{
+  byte Solution1;                                     // 1st solution byte: valid and high Z flags
+  int Address;
+
+  if((Frequency10 < 0) || (Frequency10 >= VMAXFREQUENCY))
+    return false;
+//
+// get memory start address
+// (this is the same as the offset into the EEPROM block 1, 2 or 3)
+//
+  Address = VSOLUTIONSIZE * Frequency10;
+  Solution1 = SolutionBuffer[Address++];
+  if((Solution1 & 0b00000001) != 0)                   // if bottom bit is set, no solution
+    return false;
+  *HighZ = ((Solution1 & 0b10000000) != 0);
+  *L = SolutionBuffer[Address++];
+  *C = SolutionBuffer[Address];
+  return true;
+}
+
+
+
 //
 // handle a frequency change message
 // search locally (0 to +/- 50KHz) to find a solution
 //
 void SetupForNewFrequency(void)
 {
-  byte Solution1, Solution2, Solution3;               // 3 solution bytes  
-  int TestAddress;                                    // address we are testing to see if it has a solution
-  int TestFrequency;                                  // frequency value we are testing for
+  byte LValue, CValue;                                // solution found
   int Cntr;
   bool SolutionFound = false;                         // true if we get a hit
   bool IsHighZ = false;
@@ -402,22 +518,10 @@ void SetupForNewFrequency(void)
 //
   for(Cntr=0; Cntr < VNUMSEARCHSIZE; Cntr++)
   {
-    TestFrequency = GTunedFrequency10 + GLocalSearch[Cntr];     // start, +1, -1, +2, -2...
-    if((TestFrequency >= 0) && (TestFrequency < VMAXFREQUENCY))
+    if(GetStoredSolution(GTunedFrequency10 + GLocalSearch[Cntr], &LValue, &CValue, &IsHighZ))     // start, +1, -1, +2, -2...
     {
-//
-// get memory start address
-// (this is the same as the offset into the EEPROM block 1, 2 or 3)
-//
-      TestAddress = VSOLUTIONSIZE * TestFrequency;
-      Solution1 = SolutionBuffer[TestAddress++];          // read the 3 solution bytes; then see if valid
-      Solution2 = SolutionBuffer[TestAddress++];
-      Solution3 = SolutionBuffer[TestAddress];
-      if((Solution1 & 0b00000001) == 0)                   // if bottom bit is zero
-      {
-        SolutionFound = true;                             // we have found a match
-        break;
-      }
+      SolutionFound = true;                             // we have found a match
+      break;
     }
   }
     // if we have a solution, set it and send success; else set bypass
@@ -426,10 +530,8 @@ void SetupForNewFrequency(void)
   {
     if(SolutionFound)
     {
-      if(Solution1 & 0b10000000)
-        IsHighZ = true;
-      SetInductance(Solution2);             // inductance 0-255
-      SetCapacitance(Solution3);            // capacitance 0-255
+      SetInductance(LValue);                // inductance 0-255
+      SetCapacitance(CValue);               // capacitance 0-255
       SetHiLoZ(IsHighZ);                    // true for low Z (relay=1)
     }
     else
@@ -501,6 +603,40 @@ void SetATUQuickTune(bool State)
   GQuickTuneEnabled = State;
 }
 
+//
+// handle tuning strategy message from PC
+// select the strategy for subsequent tunes, and save it
+//
+void SetATUStrategy(byte Strategy)
+{
+  SetTuneStrategy(Strategy);
+  EEWriteStrategy(GTuneStrategy);
+}
+
+//
+// handle tune resume time message from PC
+// set the time a cancelled tune can be resumed for, and save it
+//
+void SetATUResumeTime(byte Seconds)
+{
+  SetResumeTime(Seconds);
+  EEWriteResumeTime(Seconds);
+}
+
+//
+// handle status report interval message from PC
+// parameter in ms; 0 cancels periodic reports
+// the first report is sent straight away
+//
+void SetStatusReportInterval(int Interval)
+{
+  if(Interval == 0)
+    GStatusReportTicks = 0;
+  else
+    GStatusReportTicks = max(Interval / VMSPERTICK, 1);
+  GStatusReportCountdown = 0;
+}
+
 //
 // handle frequency change CAT message from PC
 // this arrives as a string, not an int
@@ -517,7 +653,7 @@ void SetNewFrequency(char* FreqString)
 //
 // set the frequency the algorithm should use
 //
-  FindFreqRow(GTunedFrequency10/100);                                     // set algorithm frequency, in units of 1MHz
+  FindFreqRow(GTunedFrequency10);                                         // set algorithm frequency, in units of 10KHz
 //
 // now see if we have a solution
 //
@@ -653,6 +789,22 @@ void HandleCATCommandNumParam(ECATCommands MatchedCAT, int ParsedParam)
     case eZZZE:                                                       // fine tune L/C
       HandleLCFineTune(ParsedParam);
       break;
+
+    case eZZOT:                                                       // status report interval
+      SetStatusReportInterval(ParsedParam);
+      break;
+
+    case eZZOD:                                                       // tune trace dump
+      SendTuneTrace(ParsedParam);
+      break;
+
+    case eZZOG:                                                       // tuning strategy
+      SetATUStrategy(ParsedParam);
+      break;
+
+    case eZZOR:                                                       // tune resume time
+      SetATUResumeTime(ParsedParam);
+      break;
   }
 }
 
@@ -667,6 +819,18 @@ void HandleCATCommandNoParam(ECATCommands MatchedCAT)
     case eZZZS:                                                       // s/w version reply
       MakeSoftwareVersionMessage();
       break;
+
+    case eZZOS:                                                       // ATU status reply
+      MakeStatusMessage();
+      break;
+
+    case eZZOG:                                                       // tuning strategy reply
+      MakeCATMessageNumeric(eZZOG, GTuneStrategy);
+      break;
+
+    case eZZOR:                                                       // tune resume time reply
+      MakeCATMessageNumeric(eZZOR, GResumeTime);
+      break;
   }
 }
 
@@ -712,6 +876,9 @@ void HandleCATCommandStringParam(ECATCommands MatchedCAT, char* ParsedParam)
 // tune hardwired input ISR handler
 // this triggers on falling edge, to trigger a "tune request"
 // we assume it to come from an FPGA source, so no bounce
+// the request is only latched here: AlgorithmTick starts the tune when PTT is pressed
+// (starting a tune searches stored solutions and sets up the algorithm: too much for an ISR,
+// and it would race with the algorithm tick)
 //
 void HWTuneISR(void)
 {
@@ -723,11 +890,7 @@ void HWTuneISR(void)
     Serial.println("HW TUNE");                                // debug to confirm state
 #endif
     if(GATUEnabled)
-    {
-      GPCTuneActive = true;
-      if(GTuneHWPressed && GPTTPressed)
-        InitiateTune(GQuickTuneEnabled);                               // try quick tune
-    }
+      GPCTuneActive = true;                                     // tune request, started by AlgorithmTick
   }
 }
 
@@ -827,6 +990,24 @@ void CatHandlerTick()
     }
   }
 
+//
+// if the PC has subscribed to status reports, send one when due
+//
+  if(GStatusReportTicks != 0)
+  {
+    if(GStatusReportCountdown == 0)
+    {
+      GStatusReportCountdown = GStatusReportTicks - 1;
+      MakeStatusMessage();
+    }
+    else
+      GStatusReportCountdown--;
+  }
+//
+// send the next few records of a tune trace dump, if one has been requested
+//
+  TraceDumpTick();
+
 //
 // in standalone mode, poll for frequency and check antenna select inputs
 //
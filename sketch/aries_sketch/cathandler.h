@@ -20,7 +20,7 @@
 // accessible global variables
 //
 extern volatile bool GPTTPressed;                      // true if PTT pressed (ie TX active). Set by interrupt
-extern bool GPCTuneActive;                             // true if TUNE is in progress as signalled by PC (note PTT will be detected first)
+extern volatile bool GPCTuneActive;                    // true if TUNE is in progress as signalled by PC (note PTT will be detected first)
 extern bool GATUEnabled;                               // true if the ATU is enabled
 extern bool GQuickTuneEnabled;                         // true if quick tune allowed
 extern bool GValidSolution;                            // true if a valid tune solution found
@@ -65,6 +65,13 @@ void CATHandlePushbutton(byte Button, bool IsPressed, bool IsLongPressed);
 void SetTuneResult(bool Successful, byte Inductance, byte Capacitance, bool IsHighZ);
 
 
+//
+// get the stored solution for a frequency (10KHz units), for the current antenna
+// returns false if there is no valid solution stored
+//
+bool GetStoredSolution(int Frequency10, byte* L, byte* C, bool* HighZ);
+
+
 //
 // handlers for received CAT commands
 //
@@ -107,6 +114,26 @@ bool EEReadEnabled();
 void EEWriteQuick(bool Value);
 bool EEReadQuick();
 
+
+//
+// function to write, read tuning strategy selection
+//
+void EEWriteStrategy(byte Value);
+byte EEReadStrategy();
+
+
+//
+// function to write, read cancelled tune resume time
+//
+void EEWriteResumeTime(byte Value);
+byte EEReadResumeTime();
+
+//
+// function to write, read display link baud rate
+//
+void EEWriteDisplayBaud(byte Value);
+byte EEReadDisplayBaud();
+
 //
 // function to write, read new ATU display scale for standalone mode
 //
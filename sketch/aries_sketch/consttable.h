@@ -0,0 +1,34 @@
+/////////////////////////////////////////////////////////////////////////
+//
+// Aries ATU controller sketch by Laurence Barker G8NJJ
+// this sketch controls an L-match ATU network
+// with a CAT interface to connect to an HPSDR control program
+// copyright (c) Laurence Barker G8NJJ 2019
+//
+// the code is written for an Arduino Nano 33 IoT module
+//
+// consttable.h: helpers to build constant tables at compile time
+// a constexpr function makes one row from its index; MakeTable-style functions
+// expand it over an index list, so the table is constant initialised (in flash)
+/////////////////////////////////////////////////////////////////////////
+#ifndef __consttable_h
+#define __consttable_h
+
+
+//
+// index lists, to expand a generator over every row
+//
+template<unsigned int... I> struct SIndexList {};
+template<unsigned int N, unsigned int... I> struct SMakeIndexList : SMakeIndexList<N - 1, N - 1, I...> {};
+template<unsigned int... I> struct SMakeIndexList<0, I...> { typedef SIndexList<I...> Type; };
+
+//
+// a table as a struct, so that a constexpr function can return it
+//
+template<typename T, unsigned int N> struct STableOf
+{
+  T Rows[N];
+};
+
+
+#endif
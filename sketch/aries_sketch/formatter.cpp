@@ -0,0 +1,166 @@
+/////////////////////////////////////////////////////////////////////////
+//
+// Aries ATU controller sketch by Laurence Barker G8NJJ
+// this sketch controls an L-match ATU network
+// with a CAT interface to connect to an HPSDR control program
+// copyright (c) Laurence Barker G8NJJ 2019
+//
+// the code is written for an Arduino Nano 33 IoT module
+//
+// formatter.cpp: text formatter for display and CAT commands
+/////////////////////////////////////////////////////////////////////////
+
+#include "formatter.h"
+
+
+#define VMAXFORMATDIGITS 10                 // digits in the largest unsigned long
+#define VASCII0 0x30                        // zero character in ASCII
+
+
+//
+// start a new string in Buffer
+//
+void FormatBegin(SFormatter* Fmt, char* Buffer, unsigned int Size)
+{
+  Fmt -> Ptr = Buffer;
+  Fmt -> Last = Buffer + Size - 1;
+  *Buffer = 0;
+}
+
+
+//
+// append one character
+//
+void FormatChar(SFormatter* Fmt, char Ch)
+{
+  if(Fmt -> Ptr < Fmt -> Last)
+  {
+    *Fmt -> Ptr++ = Ch;
+    *Fmt -> Ptr = 0;
+  }
+}
+
+
+//
+// append a string
+//
+void FormatLiteral(SFormatter* Fmt, const char* Str)
+{
+  char* Ptr = Fmt -> Ptr;
+
+  while((*Str != 0) && (Ptr < Fmt -> Last))
+    *Ptr++ = *Str++;
+  *Ptr = 0;
+  Fmt -> Ptr = Ptr;
+}
+
+
+//
+// append a string, truncated or padded with spaces to Width characters
+//
+void FormatPadded(SFormatter* Fmt, const char* Str, byte Width)
+{
+  char* Ptr = Fmt -> Ptr;
+
+  while((Width != 0) && (Ptr < Fmt -> Last))
+  {
+    if(*Str != 0)
+      *Ptr++ = *Str++;
+    else
+      *Ptr++ = ' ';
+    Width--;
+  }
+  *Ptr = 0;
+  Fmt -> Ptr = Ptr;
+}
+
+
+//
+// append an unsigned number: at least MinDigits digits, with a decimal point
+// before the last NumDP digits (none if NumDP=0)
+// the digits are found least significant first, so there is one divide per digit
+//
+static void FormatNumber(SFormatter* Fmt, unsigned long Value, byte MinDigits, byte NumDP)
+{
+  char Digits[VMAXFORMATDIGITS + 1];        // digits in reverse order, and decimal point
+  byte CharCount = 0;                       // characters in Digits[]
+  byte DigitCount = 0;                      // digits found
+  unsigned long Quotient;
+  char* Ptr = Fmt -> Ptr;
+
+  if(MinDigits > VMAXFORMATDIGITS)
+    MinDigits = VMAXFORMATDIGITS;
+  if(NumDP >= VMAXFORMATDIGITS)
+    NumDP = VMAXFORMATDIGITS - 1;
+  if(MinDigits <= NumDP)                    // always a digit before the decimal point
+    MinDigits = NumDP + 1;
+
+  do
+  {
+    if((DigitCount == NumDP) && (NumDP != 0))
+      Digits[CharCount++] = '.';
+    Quotient = Value / 10;
+    Digits[CharCount++] = (char)(Value - Quotient * 10) + VASCII0;
+    Value = Quotient;
+    DigitCount++;
+  } while((Value != 0) || (DigitCount < MinDigits));
+//
+// now copy out, most significant first
+//
+  while((CharCount != 0) && (Ptr < Fmt -> Last))
+    *Ptr++ = Digits[--CharCount];
+  *Ptr = 0;
+  Fmt -> Ptr = Ptr;
+}
+
+
+//
+// append a signed integer
+//
+void FormatInt(SFormatter* Fmt, long Value)
+{
+  FormatFixed(Fmt, Value, 0);
+}
+
+
+//
+// append a signed fixed point value with NumDP decimal places
+//
+void FormatFixed(SFormatter* Fmt, long Value, byte NumDP)
+{
+  unsigned long Magnitude = (unsigned long)Value;
+
+  if(Value < 0)
+  {
+    FormatChar(Fmt, '-');
+    Magnitude = 0UL - Magnitude;            // (also correct for the most negative value)
+  }
+  FormatNumber(Fmt, Magnitude, 1, NumDP);
+}
+
+
+//
+// append a positive integer padded with leading zeros
+//
+void FormatDigits(SFormatter* Fmt, unsigned long Value, byte NumDigits)
+{
+  FormatNumber(Fmt, Value, NumDigits, 0);
+}
+
+
+//
+// append a fixed width field, clipped to the largest value that fits
+//
+void FormatField(SFormatter* Fmt, long Value, byte NumDigits)
+{
+  long Limit = 1;
+  byte Cntr;
+
+  for(Cntr = 0; Cntr < NumDigits; Cntr++)
+    Limit *= 10;
+  if(Value < 0)
+    Value = 0;
+  else if(Value >= Limit)
+    Value = Limit - 1;
+  FormatNumber(Fmt, Value, NumDigits, 0);
+}
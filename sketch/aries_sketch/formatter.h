@@ -0,0 +1,80 @@
+/////////////////////////////////////////////////////////////////////////
+//
+// Aries ATU controller sketch by Laurence Barker G8NJJ
+// this sketch controls an L-match ATU network
+// with a CAT interface to connect to an HPSDR control program
+// copyright (c) Laurence Barker G8NJJ 2019
+//
+// the code is written for an Arduino Nano 33 IoT module
+//
+// formatter.h: text formatter for display and CAT commands
+// a cursor appends numbers and text to a caller's buffer, with no strlen() or
+// strcat(); the buffer is never overrun (text is truncated) and is always 0 terminated
+/////////////////////////////////////////////////////////////////////////
+#ifndef __formatter_h
+#define __formatter_h
+#include <Arduino.h>
+
+
+//
+// format cursor
+//
+struct SFormatter
+{
+  char* Ptr;                                // where the next character goes (always holds the terminating 0)
+  char* Last;                               // last buffer position: reserved for the terminating 0
+};
+
+
+//
+// start a new string in Buffer; Size is the buffer size in bytes, including the terminating 0
+// use as FormatBegin(&Fmt, Str, sizeof(Str));
+//
+void FormatBegin(SFormatter* Fmt, char* Buffer, unsigned int Size);
+
+
+//
+// append one character
+//
+void FormatChar(SFormatter* Fmt, char Ch);
+
+
+//
+// append a string
+//
+void FormatLiteral(SFormatter* Fmt, const char* Str);
+
+
+//
+// append a string, truncated or padded with spaces to exactly Width characters
+//
+void FormatPadded(SFormatter* Fmt, const char* Str, byte Width);
+
+
+//
+// append a signed integer, with no leading zeros
+//
+void FormatInt(SFormatter* Fmt, long Value);
+
+
+//
+// append a signed fixed point value with NumDP decimal places
+// eg Value=123, NumDP=1 gives "12.3"; Value=3 gives "0.3"
+//
+void FormatFixed(SFormatter* Fmt, long Value, byte NumDP);
+
+
+//
+// append a positive integer, padded with leading zeros to at least NumDigits (max 10) digits
+//
+void FormatDigits(SFormatter* Fmt, unsigned long Value, byte NumDigits);
+
+
+//
+// append a fixed width field of exactly NumDigits (max 9) digits, padded with leading zeros
+// the value is clipped to 0 and the largest that fits, so later fields don't move
+//
+void FormatField(SFormatter* Fmt, long Value, byte NumDigits);
+
+
+#endif
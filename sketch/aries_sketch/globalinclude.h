@@ -33,6 +33,7 @@
 
 //
 // define this variable if algorithm debug messages are to be printed
+// (step by step detail is always recorded in the tune trace: read it with ZZOD)
 //
 //#define CONDITIONAL_ALG_DEBUG 1
 
@@ -32,6 +32,7 @@ byte StoredAntennaTXTRValue;                // TX setting: TR (bit 0) ant select
 bool StoredHiLoZ;                           // true if Lo impedance
 float GVSWR;                                // calculated VSWR value
 unsigned int GForwardPower;                 // forward power (W)
+float GForwardWatts;                        // forward power (W), not rounded
 
 bool GResendSPI;                            // true if SPI data must be shifted again
 bool GSPIShiftInProgress;                   // true if SPI shify is currently happening
@@ -260,6 +261,7 @@ void HWDriverTick(void)
 #endif
   
   Unit = VFwd * VFwd/50;                            // calculate power in 50 ohm line
+  GForwardWatts = Unit;
   GForwardPower = int(Unit);
 
 //
@@ -0,0 +1,595 @@
+/////////////////////////////////////////////////////////////////////////
+//
+// Aries ATU controller sketch by Laurence Barker G8NJJ
+// this sketch controls an L-match ATU network
+// with a CAT interface to connect to an HPSDR control program
+// copyright (c) Laurence Barker G8NJJ 2019
+//
+// the code is written for an Arduino Nano 33 IoT module
+//
+// lnetwork.cpp:  model of the L network used to tune directly
+//
+// the VSWR bridge only tells us |reflection coefficient|. But if we measure it
+// at a few probe settings of known L and C, only one load impedance fits all of them.
+// the load is found by least squares over the load reflection coefficient:
+// its magnitude starts from the measurement with no L or C switched in;
+// a scan over its phase finds the region of the answer; then it is refined.
+// then the L network equations give the L and C needed for each Z setting.
+// in soft float on the SAMD21 the whole solve is far too long for one 16ms tick
+// (each probe error evaluation runs 6 gamma predictions with trig; each L network
+// solution scans every relay code), so it is done in slices, one per tick.
+//
+// high Z setting: C shunt across the load, L in series towards the TX
+// low Z setting: L in series with the load, C shunt on the TX side
+/////////////////////////////////////////////////////////////////////////
+
+#include "lnetwork.h"
+#include "globalinclude.h"
+
+
+#define VZ0 50.0F                       // system impedance
+#define VMAXPROBES 6                    // number of probe measurements
+#define VPHASESTEPS 32                  // steps in initial phase scan
+#define VMAXREFINE 40                   // max refinement iterations
+#define VMAXGAMMA 0.98F                 // largest load reflection coefficient considered
+#define VGOODGAMMA 0.2F                 // predicted reflection coefficient for a match (VSWR 1.5)
+#define VBADGAMMA 0.333F                // predicted reflection coefficient for no match (VSWR 2)
+#define VLOGSTEPMIN 0.125F              // smallest reactance (relative to Z0) in log reactance steps
+#define VLOGSTEPMAX 8.1F                // largest
+#define VLOGSTEPRATIO 2.83F             // ratio between log reactance steps
+#define VSCANPERTICK 12                 // phase scan steps per tick (12 probe error evaluations)
+#define VREFINEPERTICK 3                // refinement iterations per tick (up to 12 probe error evaluations)
+
+
+//
+// component values for each relay bit, for the hardware revision
+// (from documentation/atu toroids.xlsx: achieved inductance, and combined capacitor values)
+// inductance in uH, capacitance in pF; the stray values are estimates
+//
+#define VSTRAYL 0.05F
+#define VSTRAYC 5.0F
+#if HWVERSION >= 4
+const float GInductorValues[8] = {0.007F, 0.028F, 0.112F, 0.175F, 0.4116F, 0.6804F, 1.4196F, 3.0324F};
+const float GCapacitorValues[8] = {10.0F, 19.5F, 41.0F, 90.0F, 165.0F, 340.0F, 650.0F, 1350.0F};
+#else
+const float GInductorValues[8] = {0.028F, 0.063F, 0.175F, 0.3024F, 0.5376F, 1.21F, 2.428F, 4.838F};
+const float GCapacitorValues[8] = {9.0F, 19.5F, 41.0F, 75.0F, 165.0F, 340.0F, 750.0F, 1650.0F};
+#endif
+
+
+//
+// structure for a probe setting
+// reactances are given relative to the system impedance, then converted for the frequency
+//
+struct SProbeSetting
+{
+  bool HighZ;                         // true for high Z setting
+  float XL;                           // inductor reactance / Z0
+  float BC;                           // capacitor susceptance * Z0
+};
+
+//
+// probe set: no L or C, then L and C separately at two values each, then both together
+// series L and shunt C move the reflection coefficient in different directions,
+// so between them they resolve the load phase
+//
+const SProbeSetting GProbeSettings[VMAXPROBES] =
+{
+  {false, 0.0F, 0.0F},                // nothing switched in: gives |load reflection coefficient|
+  {false, 1.0F, 0.0F},                // series L
+  {false, 3.0F, 0.0F},
+  {true, 0.0F, 1.0F},                 // shunt C
+  {true, 0.0F, 3.0F},
+  {true, 1.0F, 1.0F}                  // both
+};
+
+
+//
+// structure for a probe measurement
+//
+struct SProbeMeasurement
+{
+  float XL;                           // inductor reactance (ohms)
+  float BC;                           // capacitor susceptance (S)
+  bool HighZ;                         // true for high Z setting
+  float Gamma;                        // measured |reflection coefficient|
+};
+
+
+
+//
+// model solve phases: each is run in slices, one slice per tick
+//
+enum ESolvePhase
+{
+  eSolveIdle,                           // not started (or probes changed since)
+  eSolveScan,                           // scanning load phase
+  eSolveRefine,                         // refining load magnitude and phase
+  eSolveHighZ,                          // L network solution for high Z setting
+  eSolveLowZ,                           // L network solution for low Z setting
+  eSolveDone
+};
+
+
+//
+// global variables
+//
+float GModelOmega;                      // 2*pi*F (F in MHz); 0 if no frequency
+SProbeMeasurement GProbes[VMAXPROBES];  // measurements
+byte GNumProbes;                        // number of measurements stored
+//
+// model solve state
+//
+ESolvePhase GSolvePhase;                // phase of the solve
+byte GSolveCount;                       // scan steps or refinement iterations done
+byte GSolveLMax, GSolveCMax;            // relay setting limits for the solution
+float GBestGamma, GBestPhase;           // load estimate so far
+float GBestError;                       // its least squares error
+float GGammaStep, GPhaseStep;           // refinement step sizes
+float GLoadR, GLoadX;                   // estimated load (ohms)
+byte GLHigh, GCHigh, GLLow, GCLow;      // solutions for each Z setting
+float GGammaHigh, GGammaLow;            // and their predicted |reflection coefficients|
+
+
+
+//
+// get component value for a relay setting
+// inductance in uH, capacitance in pF
+//
+float GetInductanceValue(byte Code)
+{
+  byte Bit;
+  float Value = VSTRAYL;
+
+  for(Bit = 0; Bit < 8; Bit++)
+    if(Code & (1 << Bit))
+      Value += GInductorValues[Bit];
+  return Value;
+}
+
+float GetCapacitanceValue(byte Code)
+{
+  byte Bit;
+  float Value = VSTRAYC;
+
+  for(Bit = 0; Bit < 8; Bit++)
+    if(Code & (1 << Bit))
+      Value += GCapacitorValues[Bit];
+  return Value;
+}
+
+
+//
+// find relay setting closest to a component value (uH, pF)
+// the relay values aren't exactly binary weighted, so check every setting up to the limit
+//
+byte FindInductanceCode(float Value, byte LMax)
+{
+  int Code;
+  byte Best = 0;
+  float Error, BestError = 1.0E9;
+
+  for(Code = 0; Code <= LMax; Code++)
+  {
+    Error = fabs(GetInductanceValue(Code) - Value);
+    if(Error < BestError)
+    {
+      BestError = Error;
+      Best = Code;
+    }
+  }
+  return Best;
+}
+
+byte FindCapacitanceCode(float Value, byte CMax)
+{
+  int Code;
+  byte Best = 0;
+  float Error, BestError = 1.0E9;
+
+  for(Code = 0; Code <= CMax; Code++)
+  {
+    Error = fabs(GetCapacitanceValue(Code) - Value);
+    if(Error < BestError)
+    {
+      BestError = Error;
+      Best = Code;
+    }
+  }
+  return Best;
+}
+
+
+
+//
+// calculate |reflection coefficient| at the TX for a load R+jX,
+// given inductor reactance XL and capacitor susceptance BC
+//
+float PredictGamma(float R, float X, float XL, float BC, bool HighZ)
+{
+  float Re, Im, Mag, Den;
+  float NumRe, NumIm, DenRe, DenIm;
+
+  if(HighZ)                                         // shunt C across load, then series L
+  {
+    Mag = R*R + X*X;
+    Re = R/Mag;                                     // load admittance
+    Im = -X/Mag + BC;
+    Mag = Re*Re + Im*Im;
+    Re = Re/Mag;                                    // back to impedance, then add L
+    Im = -Im/Mag + XL;
+  }
+  else                                              // series L with load, then shunt C
+  {
+    Im = X + XL;
+    Mag = R*R + Im*Im;
+    Re = R/Mag;                                     // admittance, then add C
+    Im = -Im/Mag + BC;
+    Mag = Re*Re + Im*Im;
+    Re = Re/Mag;                                    // back to impedance
+    Im = -Im/Mag;
+  }
+//
+// gamma = (Z - Z0) / (Z + Z0)
+//
+  NumRe = Re - VZ0;
+  NumIm = Im;
+  DenRe = Re + VZ0;
+  DenIm = Im;
+  Den = DenRe*DenRe + DenIm*DenIm;
+  if(Den < 1.0E-6)
+    return 1.0F;
+  return sqrt((NumRe*NumRe + NumIm*NumIm) / Den);
+}
+
+
+
+//
+// convert a load reflection coefficient (magnitude and phase) to an impedance
+//
+void GammaToImpedance(float Gamma, float Phase, float* R, float* X)
+{
+  float GRe, GIm, Den;
+
+  GRe = Gamma * cos(Phase);
+  GIm = Gamma * sin(Phase);
+  Den = (1.0F - GRe)*(1.0F - GRe) + GIm*GIm;
+  *R = VZ0 * (1.0F - GRe*GRe - GIm*GIm) / Den;
+  *X = VZ0 * 2.0F * GIm / Den;
+}
+
+
+//
+// least squares error of a proposed load against all the probe measurements
+//
+float ProbeError(float Gamma, float Phase)
+{
+  float R, X, Error, Sum = 0.0F;
+  byte Cntr;
+  SProbeMeasurement* Ptr;
+
+  GammaToImpedance(Gamma, Phase, &R, &X);
+  for(Cntr = 0; Cntr < GNumProbes; Cntr++)
+  {
+    Ptr = GProbes + Cntr;
+    Error = PredictGamma(R, X, Ptr -> XL, Ptr -> BC, Ptr -> HighZ) - Ptr -> Gamma;
+    Sum += Error*Error;
+  }
+  return Sum;
+}
+
+
+
+//
+// set the frequency the model is to use
+//
+void SetModelFrequency(unsigned int Frequency10)
+{
+  GModelOmega = 2.0F * M_PI * (float)Frequency10 / 100.0F;
+  GNumProbes = 0;
+  GSolvePhase = eSolveIdle;
+}
+
+
+//
+// get a probe setting
+// returns false if there are no more probes (or no frequency is known)
+//
+bool GetProbeSetting(byte Probe, byte LMax, byte CMax, byte* L, byte* C, bool* HighZ)
+{
+  const SProbeSetting* Ptr;
+
+  if((Probe >= VMAXPROBES) || (GModelOmega == 0.0F))
+    return false;
+  Ptr = GProbeSettings + Probe;
+  *HighZ = Ptr -> HighZ;
+  *L = 0;
+  *C = 0;
+  if(Ptr -> XL != 0.0F)
+    *L = FindInductanceCode(Ptr -> XL * VZ0 / GModelOmega, LMax);
+  if(Ptr -> BC != 0.0F)
+    *C = FindCapacitanceCode(Ptr -> BC * 1.0E6F / (VZ0 * GModelOmega), CMax);
+  return true;
+}
+
+
+//
+// store a probe measurement
+//
+void AddProbeMeasurement(byte L, byte C, bool HighZ, unsigned int VSWR)
+{
+  SProbeMeasurement* Ptr;
+  float Value;
+
+  if(GNumProbes < VMAXPROBES)
+  {
+    Ptr = GProbes + GNumProbes++;
+    Value = max((float)VSWR / 100.0F, 1.0F);
+    Ptr -> Gamma = (Value - 1.0F) / (Value + 1.0F);
+    Ptr -> XL = GModelOmega * GetInductanceValue(L);
+    Ptr -> BC = GModelOmega * GetCapacitanceValue(C) * 1.0E-6F;
+    Ptr -> HighZ = HighZ;
+    GSolvePhase = eSolveIdle;
+  }
+}
+
+
+//
+// load estimate, first phase: magnitude from the first probe (nothing switched in);
+// then scan phase. VSCANPERTICK steps per call; returns true when the scan is complete
+//
+bool ScanLoadPhase(void)
+{
+  float Phase, Error;
+  byte Cntr;
+
+  for(Cntr = 0; (Cntr < VSCANPERTICK) && (GSolveCount < VPHASESTEPS); Cntr++)
+  {
+    Phase = (2.0F * M_PI * GSolveCount++) / VPHASESTEPS;
+    Error = ProbeError(GBestGamma, Phase);
+    if(Error < GBestError)
+    {
+      GBestError = Error;
+      GBestPhase = Phase;
+    }
+  }
+  return (GSolveCount >= VPHASESTEPS);
+}
+
+
+//
+// load estimate, second phase: refine magnitude and phase together: try a step each way
+// in each; when nothing is better, halve the steps.
+// VREFINEPERTICK iterations per call; returns true when refinement is complete
+//
+bool RefineLoad(void)
+{
+  float Gamma, Phase, Error;
+  byte Cntr;
+  bool Improved;
+
+  for(Cntr = 0; (Cntr < VREFINEPERTICK) && (GSolveCount < VMAXREFINE); Cntr++)
+  {
+    GSolveCount++;
+    Improved = false;
+    Gamma = constrain(GBestGamma + GGammaStep, 0.0F, VMAXGAMMA);
+    Error = ProbeError(Gamma, GBestPhase);
+    if(Error >= GBestError)
+    {
+      Gamma = constrain(GBestGamma - GGammaStep, 0.0F, VMAXGAMMA);
+      Error = ProbeError(Gamma, GBestPhase);
+    }
+    if(Error < GBestError)
+    {
+      GBestError = Error;
+      GBestGamma = Gamma;
+      Improved = true;
+    }
+    Phase = GBestPhase + GPhaseStep;
+    Error = ProbeError(GBestGamma, Phase);
+    if(Error >= GBestError)
+    {
+      Phase = GBestPhase - GPhaseStep;
+      Error = ProbeError(GBestGamma, Phase);
+    }
+    if(Error < GBestError)
+    {
+      GBestError = Error;
+      GBestPhase = Phase;
+      Improved = true;
+    }
+    if(!Improved)
+    {
+      GGammaStep *= 0.5F;
+      GPhaseStep *= 0.5F;
+    }
+  }
+  return (GSolveCount >= VMAXREFINE);
+}
+
+
+//
+// calculate the L network setting to match load R+jX for one Z setting
+// the ideal values are rounded to the nearest relay settings
+// returns the predicted |reflection coefficient| for the setting
+//
+float SolveLNetwork(float R, float X, bool HighZ, byte LMax, byte CMax, byte* L, byte* C)
+{
+  float G, B, BNew, XNew;
+  float XL = 0.0F;
+  float BC = 0.0F;
+
+  if(HighZ)
+  {
+//
+// shunt C brings the load conductance to 1/Z0 (possible if G <= 1/Z0): series L then cancels the reactance left
+//
+    G = R / (R*R + X*X);
+    B = -X / (R*R + X*X);
+    if(G <= 1.0F/VZ0)
+    {
+      BNew = sqrt(G/VZ0 - G*G);
+      BC = max(BNew - B, 0.0F);
+      XL = VZ0 * BNew / G;
+    }
+  }
+  else
+  {
+//
+// series L brings the load resistance to Z0 in parallel form (possible if R <= Z0): shunt C then cancels the susceptance left
+//
+    if(R <= VZ0)
+    {
+      XNew = sqrt(VZ0*R - R*R);
+      XL = max(XNew - X, 0.0F);
+      BC = XNew / (VZ0 * R);
+    }
+  }
+  *L = FindInductanceCode(XL / GModelOmega, LMax);
+  *C = FindCapacitanceCode(BC * 1.0E6F / GModelOmega, CMax);
+  return PredictGamma(R, X, GModelOmega * GetInductanceValue(*L), GModelOmega * GetCapacitanceValue(*C) * 1.0E-6F, HighZ);
+}
+
+
+//
+// start the model solve from the stored probe measurements
+//
+bool StartModelSolve(byte LMax, byte CMax)
+{
+  if((GNumProbes < VMAXPROBES) || (GModelOmega == 0.0F) || (GSolvePhase == eSolveDone))
+    return false;
+  if(GSolvePhase == eSolveIdle)
+  {
+    GSolveLMax = LMax;
+    GSolveCMax = CMax;
+    GBestGamma = constrain(GProbes[0].Gamma, 0.02F, VMAXGAMMA);
+    GBestPhase = 0.0F;
+    GBestError = 1.0E9;
+    GSolveCount = 0;
+    GSolvePhase = eSolveScan;
+  }
+  return true;
+}
+
+
+//
+// run the next slice of the model solve
+//
+bool ModelSolveStep(void)
+{
+  switch(GSolvePhase)
+  {
+    case eSolveIdle:
+    case eSolveDone:
+      return false;
+
+    case eSolveScan:
+      if(ScanLoadPhase())
+      {
+        GGammaStep = 0.1F;
+        GPhaseStep = M_PI / VPHASESTEPS;
+        GSolveCount = 0;
+        GSolvePhase = eSolveRefine;
+      }
+      break;
+
+    case eSolveRefine:
+      if(RefineLoad())
+      {
+        GammaToImpedance(GBestGamma, GBestPhase, &GLoadR, &GLoadX);
+        GSolvePhase = eSolveHighZ;
+      }
+      break;
+
+    case eSolveHighZ:
+      GGammaHigh = SolveLNetwork(GLoadR, GLoadX, true, GSolveLMax, GSolveCMax, &GLHigh, &GCHigh);
+      GSolvePhase = eSolveLowZ;
+      break;
+
+    case eSolveLowZ:
+      GGammaLow = SolveLNetwork(GLoadR, GLoadX, false, GSolveLMax, GSolveCMax, &GLLow, &GCLow);
+      GSolvePhase = eSolveDone;
+      break;
+  }
+  return true;
+}
+
+
+//
+// get the setting that best matches the estimated load
+// both Z settings are calculated; the one predicted to be better is chosen
+//
+bool FindModelSolution(byte* L, byte* C, bool* HighZ)
+{
+  if(GSolvePhase != eSolveDone)
+    return false;
+  *HighZ = (GGammaHigh < GGammaLow);
+  if(*HighZ)
+  {
+    *L = GLHigh;
+    *C = GCHigh;
+  }
+  else
+  {
+    *L = GLLow;
+    *C = GCLow;
+  }
+  return true;
+}
+
+
+//
+// decide which Z setting can match the estimated load
+//
+bool FindModelTopology(bool* HighZ)
+{
+  if(GSolvePhase != eSolveDone)
+    return false;
+  *HighZ = (GGammaHigh < GGammaLow);
+  if((GGammaHigh < VGOODGAMMA) && (GGammaLow > VBADGAMMA))
+    return true;
+  if((GGammaLow < VGOODGAMMA) && (GGammaHigh > VBADGAMMA))
+    return true;
+  return false;
+}
+
+
+//
+// get the number of probe measurements stored
+//
+byte GetNumProbeMeasurements(void)
+{
+  return GNumProbes;
+}
+
+
+//
+// get relay settings in equal steps of log reactance at the model frequency
+// the first is nothing switched in; then inductor reactance (or capacitor susceptance)
+// from VLOGSTEPMIN to VLOGSTEPMAX relative to Z0, in ratios of VLOGSTEPRATIO.
+// Settings past Max, and repeats, are left out.
+// returns the number of settings written to Codes (0 if no frequency known)
+//
+byte GetLogReactanceSteps(bool IsL, byte Max, byte* Codes, byte MaxCodes)
+{
+  byte Count = 0;
+  byte Code;
+  float X;                                          // reactance / Z0 (or susceptance * Z0)
+
+  if(GModelOmega == 0.0F)
+    return 0;
+
+  Codes[Count++] = 0;
+  for(X = VLOGSTEPMIN; (X <= VLOGSTEPMAX) && (Count < MaxCodes); X *= VLOGSTEPRATIO)
+  {
+    if(IsL)
+      Code = FindInductanceCode(X * VZ0 / GModelOmega, Max);
+    else
+      Code = FindCapacitanceCode(X * 1.0E6F / (VZ0 * GModelOmega), Max);
+    if(Code != Codes[Count-1])
+      Codes[Count++] = Code;
+    if(Code == Max)                                 // can't go any further
+      break;
+  }
+  return Count;
+}
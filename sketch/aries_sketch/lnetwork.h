@@ -0,0 +1,90 @@
+/////////////////////////////////////////////////////////////////////////
+//
+// Aries ATU controller sketch by Laurence Barker G8NJJ
+// this sketch controls an L-match ATU network
+// with a CAT interface to connect to an HPSDR control program
+// copyright (c) Laurence Barker G8NJJ 2019
+//
+// the code is written for an Arduino Nano 33 IoT module
+//
+// lnetwork.h:  model of the L network used to tune directly
+// estimates the load impedance from VSWR measured at probe settings,
+// then calculates the L/C/Z setting that matches it
+/////////////////////////////////////////////////////////////////////////
+#ifndef __lnetwork_h
+#define __lnetwork_h
+
+#include <arduino.h>
+
+
+//
+// set the frequency the model is to use
+// parameter in 10KHz units (as GTunedFrequency10); 0 if not known
+// clears any stored probe measurements
+//
+void SetModelFrequency(unsigned int Frequency10);
+
+
+//
+// get a probe setting
+// returns false if there are no more probes (or no frequency is known)
+// the probes are chosen for the model frequency, limited to LMax, CMax
+//
+bool GetProbeSetting(byte Probe, byte LMax, byte CMax, byte* L, byte* C, bool* HighZ);
+
+
+//
+// store a probe measurement
+// VSWR is 100*VSWR measured at the setting
+//
+void AddProbeMeasurement(byte L, byte C, bool HighZ, unsigned int VSWR);
+
+
+//
+// start the model solve: estimate the load from the stored probe measurements,
+// and calculate the setting that best matches it, limited to LMax, CMax.
+// the solve takes several ticks: call ModelSolveStep() each tick until it returns false
+// returns true if a solve has started (or is still in progress); false if there aren't
+// enough measurements, no frequency is known, or the solve is already complete
+//
+bool StartModelSolve(byte LMax, byte CMax);
+
+
+//
+// run the next slice of the model solve (a few ms); call once per tick
+// returns true if there was work to do, false if no solve is in progress
+//
+bool ModelSolveStep(void);
+
+
+//
+// get the setting that best matches the estimated load
+// returns true if a solution found (the solve must be complete)
+//
+bool FindModelSolution(byte* L, byte* C, bool* HighZ);
+
+
+//
+// decide which Z setting can match the estimated load
+// returns true if one Z setting is predicted to match and the other clearly can't
+// (false if the solve isn't complete)
+//
+bool FindModelTopology(bool* HighZ);
+
+
+//
+// get the number of probe measurements stored
+//
+byte GetNumProbeMeasurements(void);
+
+
+//
+// get relay settings in equal steps of log reactance at the model frequency
+// (a step of one relay code is a very different reactance change at different frequencies and codes)
+// IsL true for inductor settings, false for capacitor; Codes gets up to MaxCodes settings, in ascending value
+// returns the number of settings (0 if no frequency known)
+//
+byte GetLogReactanceSteps(bool IsL, byte Max, byte* Codes, byte MaxCodes);
+
+
+#endif
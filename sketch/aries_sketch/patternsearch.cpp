@@ -0,0 +1,166 @@
+/////////////////////////////////////////////////////////////////////////
+//
+// Aries ATU controller sketch by Laurence Barker G8NJJ
+// this sketch controls an L-match ATU network
+// with a CAT interface to connect to an HPSDR control program
+// copyright (c) Laurence Barker G8NJJ 2019
+//
+// the code is written for an Arduino Nano 33 IoT module
+//
+// patternsearch.cpp:  2D pattern search to find a local VSWR minimum
+// in L and C, with Z fixed
+//
+// this is a compass search with diagonal moves: from the base point it
+// polls the 8 neighbours at the current step size. The first one that is
+// better becomes the new base, and the same direction is tried again
+// (L network VSWR valleys are usually diagonal, so this follows them).
+// Repeated moves the same way double the step; when no neighbour is
+// better the step is halved. It finishes when a step of 1 finds nothing better.
+// tools/tunetable compares the strategies that use it with the table strategy
+// on modelled loads (eg -s 1 against -s 0).
+/////////////////////////////////////////////////////////////////////////
+
+#include "patternsearch.h"
+
+
+#define VNUMDIRECTIONS 8
+#define VMINVSWR 100                    // VSWR=1.0: can't do better than this
+
+
+//
+// the 8 move directions, in order round the compass
+// each opposite direction is 4 further on
+//
+const int GPatternDeltaL[VNUMDIRECTIONS] = {1, 1, 0, -1, -1, -1, 0, 1};
+const int GPatternDeltaC[VNUMDIRECTIONS] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+
+//
+// global variables
+//
+byte GPatternL;                         // candidate inductance value to try next
+byte GPatternC;                         // candidate capacitance value to try next
+
+byte GPatternBaseL;                     // base point L
+byte GPatternBaseC;                     // base point C
+unsigned int GPatternBaseVSWR;          // base point 100*VSWR
+byte GPatternLMax;                      // search limits
+byte GPatternCMax;
+byte GPatternStep;                      // current step size
+byte GPatternMaxStep;                   // largest step allowed
+byte GPatternDirection;                 // direction of the current candidate
+byte GPatternNumTried;                  // number of directions tried from this base at this step
+byte GPatternLastMove;                  // direction of last successful move (VNUMDIRECTIONS if none)
+byte GPatternSkipDirection;             // direction back to the point just moved from (VNUMDIRECTIONS if none)
+byte GPatternRepeatMoves;               // number of successful moves in the same direction
+
+
+
+//
+// find the next candidate from the base point
+// tries directions round from GPatternDirection; skips points outside the limits
+// and the point we have just moved from. When all directions have been tried, halve the step.
+// returns false if the step has reached zero (search finished)
+//
+bool FindPatternCandidate(void)
+{
+  int NewL, NewC;                       // deliberately int to trap under or overrange
+
+  while(true)
+  {
+    if(GPatternNumTried >= VNUMDIRECTIONS)          // nothing better found at this step
+    {
+      GPatternStep = GPatternStep >> 1;
+      if(GPatternStep == 0)
+        return false;
+      GPatternNumTried = 0;
+      GPatternSkipDirection = VNUMDIRECTIONS;       // old base is no longer a neighbour
+      GPatternRepeatMoves = 0;
+    }
+    NewL = (int)GPatternBaseL + GPatternDeltaL[GPatternDirection] * GPatternStep;
+    NewC = (int)GPatternBaseC + GPatternDeltaC[GPatternDirection] * GPatternStep;
+    if((NewL >= 0) && (NewL <= GPatternLMax) && (NewC >= 0) && (NewC <= GPatternCMax)
+      && (GPatternDirection != GPatternSkipDirection))
+    {
+      GPatternL = (byte)NewL;
+      GPatternC = (byte)NewC;
+      return true;
+    }
+    GPatternNumTried++;                             // skip this direction
+    GPatternDirection = (GPatternDirection + 1) & (VNUMDIRECTIONS-1);
+  }
+}
+
+
+
+//
+// start a pattern search from a base point
+// returns true if a candidate has been set in GPatternL, GPatternC
+//
+bool PatternSearchStart(byte L, byte C, unsigned int VSWR, byte LMax, byte CMax, byte Step, byte MaxStep)
+{
+  GPatternBaseL = L;
+  GPatternBaseC = C;
+  GPatternBaseVSWR = VSWR;
+  GPatternLMax = LMax;
+  GPatternCMax = CMax;
+  GPatternStep = max(Step, 1);
+  GPatternMaxStep = max(MaxStep, GPatternStep);
+  GPatternDirection = 0;
+  GPatternNumTried = 0;
+  GPatternLastMove = VNUMDIRECTIONS;
+  GPatternSkipDirection = VNUMDIRECTIONS;
+  GPatternRepeatMoves = 0;
+
+  if(VSWR == PATTERNNOTMEASURED)                    // measure the base point first
+  {
+    GPatternL = L;
+    GPatternC = C;
+    return true;
+  }
+  else if(VSWR <= VMINVSWR)
+    return false;
+  else
+    return FindPatternCandidate();
+}
+
+
+
+//
+// process the VSWR measured at the last candidate, and find the next
+// returns false if the search has finished
+//
+bool PatternSearchStep(unsigned int VSWR)
+{
+  if(GPatternBaseVSWR == PATTERNNOTMEASURED)        // this was the base point measurement
+    GPatternBaseVSWR = VSWR;
+  else if(VSWR < GPatternBaseVSWR)                  // better: move there, and try the same direction again
+  {
+    GPatternBaseL = GPatternL;
+    GPatternBaseC = GPatternC;
+    GPatternBaseVSWR = VSWR;
+    GPatternNumTried = 0;
+    GPatternSkipDirection = (GPatternDirection + VNUMDIRECTIONS/2) & (VNUMDIRECTIONS-1);
+    if(GPatternDirection == GPatternLastMove)       // same way again: lengthen the step
+    {
+      if(++GPatternRepeatMoves >= 2)
+      {
+        GPatternStep = min(GPatternStep << 1, GPatternMaxStep);
+        GPatternRepeatMoves = 0;
+        GPatternSkipDirection = VNUMDIRECTIONS;     // old base is no longer a neighbour
+      }
+    }
+    else
+      GPatternRepeatMoves = 0;
+    GPatternLastMove = GPatternDirection;
+  }
+  else                                              // not better: try the next direction
+  {
+    GPatternNumTried++;
+    GPatternDirection = (GPatternDirection + 1) & (VNUMDIRECTIONS-1);
+  }
+
+  if(GPatternBaseVSWR <= VMINVSWR)                  // can't improve on a perfect match
+    return false;
+  return FindPatternCandidate();
+}
@@ -0,0 +1,43 @@
+/////////////////////////////////////////////////////////////////////////
+//
+// Aries ATU controller sketch by Laurence Barker G8NJJ
+// this sketch controls an L-match ATU network
+// with a CAT interface to connect to an HPSDR control program
+// copyright (c) Laurence Barker G8NJJ 2019
+//
+// the code is written for an Arduino Nano 33 IoT module
+//
+// patternsearch.h:  2D pattern search to find a local VSWR minimum
+// in L and C, with Z fixed
+/////////////////////////////////////////////////////////////////////////
+#ifndef __patternsearch_h
+#define __patternsearch_h
+
+#include <arduino.h>
+
+
+extern byte GPatternL;                  // candidate inductance value to try next
+extern byte GPatternC;                  // candidate capacitance value to try next
+
+
+//
+// start a pattern search from a base point
+// L, C are the base point; VSWR is its measured VSWR (100*VSWR),
+// or PATTERNNOTMEASURED if it hasn't been measured: then the base point becomes the first candidate
+// LMax, CMax are the search limits
+// Step is the starting step size; the step can grow up to MaxStep when moves keep succeeding
+// returns true if a candidate has been set in GPatternL, GPatternC
+//
+#define PATTERNNOTMEASURED 65535
+bool PatternSearchStart(byte L, byte C, unsigned int VSWR, byte LMax, byte CMax, byte Step, byte MaxStep);
+
+
+//
+// process the VSWR measured at the last candidate, and find the next
+// returns true if a new candidate has been set in GPatternL, GPatternC
+// or false if the search has finished at a local minimum
+//
+bool PatternSearchStep(unsigned int VSWR);
+
+
+#endif
@@ -0,0 +1,152 @@
+/////////////////////////////////////////////////////////////////////////
+//
+// Aries ATU controller sketch by Laurence Barker G8NJJ
+// this sketch controls an L-match ATU network
+// with a CAT interface to connect to an HPSDR control program
+// copyright (c) Laurence Barker G8NJJ 2019
+//
+// the code is written for an Arduino Nano 33 IoT module
+//
+// tablegen.h: compile time generator for the tune tables
+// builds GTuneParamArray and GStage1Array from GBandDescriptors (tunetables.h)
+// the tables are constant initialised, so they end up in flash exactly as if typed in;
+// the descriptors themselves are only used by the compiler.
+// included by algorithm.cpp, after the table structures and tunetables.h
+/////////////////////////////////////////////////////////////////////////
+#ifndef __tablegen_h
+#define __tablegen_h
+
+#include "consttable.h"
+
+
+//
+// the host tune table optimiser defines this as nothing, to make the tables writable
+//
+#ifndef TUNETABLE_CONST
+#define TUNETABLE_CONST const
+#endif
+
+//
+// and sets this to leave room for more stage 1 sweeps than the descriptors need
+//
+#ifndef VSTAGE1SPARE
+#define VSTAGE1SPARE 0
+#endif
+
+
+//
+// band row whose sweeps and parameters are used by a row
+// (general coverage rows use the band below)
+//
+constexpr unsigned int GetOwnerRow(unsigned int Row)
+{
+  return ((Row == 0) || (GBandDescriptors[Row].NumTries != 0)) ? Row : GetOwnerRow(Row - 1);
+}
+
+
+//
+// first stage 1 sweep for a row; with Row=VNUMTUNEROWS, the total number of sweeps
+//
+constexpr unsigned int GetStartRow(unsigned int Row)
+{
+  return (Row == 0) ? 0 : GetStartRow(Row - 1) + 4 * GBandDescriptors[Row - 1].NumTries;
+}
+
+#define VNUMSTAGE1ROWS GetStartRow(VNUMTUNEROWS)         // this tells how far to step
+
+
+//
+// band row that a stage 1 sweep belongs to: search up from Row
+//
+constexpr unsigned int GetSweepBand(unsigned int Sweep, unsigned int Row)
+{
+  return (Sweep < GetStartRow(Row + 1)) ? Row : GetSweepBand(Sweep, Row + 1);
+}
+
+
+//
+// make one stage 1 sweep; Index counts from the band's first sweep
+// each try is loZ step C, loZ step L, hiZ step C, hiZ step L
+//
+constexpr SSweepSet MakeSweep(unsigned int Band, unsigned int Index)
+{
+  return SSweepSet{(Index & 2) != 0, (Index & 1) != 0, 0, GBandDescriptors[Band].SweepMax,
+                   GBandDescriptors[Band].SweepStep, (byte)((Index >> 2) * GBandDescriptors[Band].FixedStep)};
+}
+
+constexpr SSweepSet GetSweep(unsigned int Sweep)
+{
+  return (Sweep >= VNUMSTAGE1ROWS) ? SSweepSet{false, false, 0, 0, 0, 0}
+    : MakeSweep(GetSweepBand(Sweep, 0), Sweep - GetStartRow(GetSweepBand(Sweep, 0)));
+}
+
+
+//
+// make one row of tune parameters
+//
+constexpr STuneParams MakeTuneParams(unsigned int Row, unsigned int Band)
+{
+  return STuneParams{GBandDescriptors[Row].FreqMax, (byte)GetStartRow(Band), (byte)(4 * GBandDescriptors[Band].NumTries),
+                     GBandDescriptors[Band].LMax, GBandDescriptors[Band].CMax, GBandDescriptors[Band].Stage1bStep,
+                     GBandDescriptors[Band].Stage2MidRange, GBandDescriptors[Band].Stage2MidStep, GBandDescriptors[Band].Stage2FineRange};
+}
+
+constexpr STuneParams GetTuneParams(unsigned int Row)
+{
+  return MakeTuneParams(Row, GetOwnerRow(Row));
+}
+
+
+//
+// checks on the descriptors, done by the compiler
+//
+constexpr bool CheckOrder(unsigned int Row)
+{
+  return (Row >= VNUMTUNEROWS) ? true
+    : (GBandDescriptors[Row].FreqMax > GBandDescriptors[Row - 1].FreqMax) && CheckOrder(Row + 1);
+}
+
+constexpr bool CheckBand(const SBandDescriptor& Band)
+{
+  return (Band.NumTries == 0) ||
+    ((Band.SweepStep != 0) && (Band.Stage1bStep != 0) && (Band.Stage2MidStep != 0)
+    && (Band.SweepMax <= Band.LMax) && (Band.SweepMax <= Band.CMax)
+    && ((Band.NumTries - 1) * Band.FixedStep <= Band.LMax) && ((Band.NumTries - 1) * Band.FixedStep <= Band.CMax));
+}
+
+constexpr bool CheckRanges(unsigned int Row)
+{
+  return (Row >= VNUMTUNEROWS) ? true : CheckBand(GBandDescriptors[Row]) && CheckRanges(Row + 1);
+}
+
+static_assert(GBandDescriptors[0].NumTries != 0, "first band descriptor must have its own stage 1 sweeps");
+static_assert(CheckOrder(1), "band descriptors must be in ascending frequency order");
+static_assert(CheckRanges(0), "stage 1 sweep or fixed values beyond LMax/CMax, or a zero step");
+static_assert(VNUMSTAGE1ROWS <= 255, "too many stage 1 sweeps for Alg1StartRow");
+
+
+template<unsigned int... I> constexpr STableOf<STuneParams, sizeof...(I)> MakeTuneParamTable(SIndexList<I...>)
+{
+  return STableOf<STuneParams, sizeof...(I)>{{GetTuneParams(I)...}};
+}
+
+template<unsigned int... I> constexpr STableOf<SSweepSet, sizeof...(I)> MakeStage1Table(SIndexList<I...>)
+{
+  return STableOf<SSweepSet, sizeof...(I)>{{GetSweep(I)...}};
+}
+
+
+//
+// the generated tables
+//
+TUNETABLE_CONST STableOf<STuneParams, VNUMTUNEROWS> GTuneParamTable = MakeTuneParamTable(SMakeIndexList<VNUMTUNEROWS>::Type());
+TUNETABLE_CONST STableOf<SSweepSet, VNUMSTAGE1ROWS + VSTAGE1SPARE> GStage1Table = MakeStage1Table(SMakeIndexList<VNUMSTAGE1ROWS + VSTAGE1SPARE>::Type());
+
+//
+// the algorithm uses them by these names; the references are resolved by the compiler, so take no RAM
+//
+static TUNETABLE_CONST STuneParams (&GTuneParamArray)[VNUMTUNEROWS] = GTuneParamTable.Rows;
+static TUNETABLE_CONST SSweepSet (&GStage1Array)[VNUMSTAGE1ROWS + VSTAGE1SPARE] = GStage1Table.Rows;
+
+
+#endif
@@ -15,6 +15,7 @@
 #include "globalinclude.h"
 #include "tiger.h"
 #include "cathandler.h"
+#include "formatter.h"
 
 //
 // input buffer
@@ -27,45 +28,30 @@ char Output[40];                                        // TX CAT msg buffer
 byte GNumCommands;                                      // number of commands in table
 
 
-//
-// lookup initial divisor from number of digits
-//
-long DivisorTable[] =
-{
-  0,                                                    // not used
-  1,                                                    // 1 digit - already have units
-  10,                                                   // 2 digits - tens is first
-  100,                                                  // 3 digits - hundreds is 1st
-  1000,                                                 // 4 digits - thousands is 1st
-  10000,                                                // 5 digits - ten thousands is 1st
-  100000,                                               // 6 digits - hundred thousands
-  1000000,                                              // millions
-  10000000,                                             // 10 millions
-  100000000,                                            // 100 millions
-  1000000000                                            // 1000 millions
-}; 
-
-
-
 //
 // array of records. This must exactly match the enum ECATCommands in tiger.h
 // and the number of commands defined here must be correct
 // (not including the final eNoCommand)
-// string, type, min value, max value, #digits, true if always signed
+// string, type, min value, max value, #digits, true if always signed, string reply length
 //
-#define VNUMCATCMDS 10
+#define VNUMCATCMDS 15
 SCATCommands GCATCommands[VNUMCATCMDS] = 
 {
-  {"ZZTU", eBool, 0, 1, 1, false},                        // TUNE on/off (from PC to Arduino)
-  {"ZZFT", eStr, 0, 0, 11, false},                        // TX frequency change (from PC to Arduino - treat as string)
-  {"ZZOA", eNum, 0, 3, 1, false},                         // RX antenna change (from PC to Arduino)
-  {"ZZOC", eNum, 0, 3, 1, false},                         // TX antenna change (from PC to Arduino)
-  {"ZZOZ", eNum, 0, 3, 1, false},                         // erase tuning solutions (from PC to Arduino)
-  {"ZZZE", eNum, 0, 999, 3, false},                       // other encoder for fine tune L/C
-  {"ZZOX", eBool, 0, 1, 1, false},                        // Tune success (from Arduino to PC)
-  {"ZZOV", eBool, 0, 1, 1, false},                        // ATU enable (from PC to Arduino)
-  {"ZZOY", eBool, 0, 1, 1, false},                        // ATU quick tune enable (from PC to Arduino)
-  {"ZZZS", eNum, 0, 9999999, 7, false}                    // s/w version
+  {"ZZTU", eBool, 0, 1, 1, false, 0},                     // TUNE on/off (from PC to Arduino)
+  {"ZZFT", eStr, 0, 0, 11, false, 0},                     // TX frequency change (from PC to Arduino - treat as string)
+  {"ZZOA", eNum, 0, 3, 1, false, 0},                      // RX antenna change (from PC to Arduino)
+  {"ZZOC", eNum, 0, 3, 1, false, 0},                      // TX antenna change (from PC to Arduino)
+  {"ZZOZ", eNum, 0, 3, 1, false, 0},                      // erase tuning solutions (from PC to Arduino)
+  {"ZZZE", eNum, 0, 999, 3, false, 0},                    // other encoder for fine tune L/C
+  {"ZZOX", eBool, 0, 1, 1, false, 0},                     // Tune success (from Arduino to PC)
+  {"ZZOV", eBool, 0, 1, 1, false, 0},                     // ATU enable (from PC to Arduino)
+  {"ZZOY", eBool, 0, 1, 1, false, 0},                     // ATU quick tune enable (from PC to Arduino)
+  {"ZZZS", eNum, 0, 9999999, 7, false, 0},                // s/w version
+  {"ZZOS", eStr, 0, 0, 0, false, 26},                     // ATU status (query from PC; reply from Arduino)
+  {"ZZOT", eNum, 0, 9999, 4, false, 0},                   // ATU status report interval, ms (from PC to Arduino)
+  {"ZZOD", eNum, 1, 8, 1, false, 32},                     // tune trace: PC requests N tunes; Arduino replies with trace records
+  {"ZZOG", eNum, 0, 9, 1, false, 0},                      // tuning strategy (set or query from PC; reply from Arduino)
+  {"ZZOR", eNum, 0, 254, 3, false, 0}                     // tune resume time, s (set or query from PC; reply from Arduino)
 };
 
 
@@ -304,20 +290,6 @@ void SendCATMessage(char* Msg)
 
 
 
-//
-// helper to append a string with a character
-//
-void Append(char* s, char ch)
-{
-  byte len;
-
-  len = strlen(s);
-  s[len++] = ch;
-  s[len] = 0;
-}
-
-
-
 //
 // create CAT message:
 // this creates a "basic" CAT command with no parameter
@@ -326,10 +298,12 @@ void Append(char* s, char ch)
 void MakeCATMessageNoParam(ECATCommands Cmd)
 {
   SCATCommands* StructPtr;
+  SFormatter Fmt;
 
   StructPtr = GCATCommands + (int)Cmd;
-  strcpy(Output, StructPtr->CATString);
-  strcat(Output, ";");
+  FormatBegin(&Fmt, Output, sizeof(Output));
+  FormatLiteral(&Fmt, StructPtr->CATString);
+  FormatChar(&Fmt, ';');
   SendCATMessage(Output);
 }
 
@@ -341,13 +315,12 @@ void MakeCATMessageNoParam(ECATCommands Cmd)
 void MakeCATMessageNumeric(ECATCommands Cmd, long Param)
 {
   byte CharCount;                  // character count to add
-  unsigned long Divisor;           // initial divisor to convert to ascii
-  unsigned long Digit;             // decimal digit found
-  char ASCIIDigit;
   SCATCommands* StructPtr;
+  SFormatter Fmt;
 
   StructPtr = GCATCommands + (int)Cmd;
-  strcpy(Output, StructPtr->CATString);
+  FormatBegin(&Fmt, Output, sizeof(Output));
+  FormatLiteral(&Fmt, StructPtr->CATString);
   CharCount = StructPtr->NumParams;
 //
 // clip the parameter to the allowed numeric range
@@ -363,16 +336,16 @@ void MakeCATMessageNumeric(ECATCommands Cmd, long Param)
   {
     if (Param < 0)
     {
-      strcat(Output, "-");
+      FormatChar(&Fmt, '-');
       Param = -Param;                   // make positive
     }
     else
-      strcat(Output, "+");
+      FormatChar(&Fmt, '+');
     CharCount--;
   }
   else if (Param < 0)                   // not always signed, but neg so it needs a sign
   {
-      strcat(Output, "-");
+      FormatChar(&Fmt, '-');
       Param = -Param;      
       CharCount--;                      // make positive
   }
@@ -380,18 +353,8 @@ void MakeCATMessageNumeric(ECATCommands Cmd, long Param)
 // we now have a positive number to fit into <CharCount> digits
 // pad with zeros if needed
 //
-  Divisor = DivisorTable[CharCount];
-  while (Divisor > 1)
-  {
-    Digit = Param / Divisor;                  // get the digit for this decimal position
-    ASCIIDigit = (char)(Digit + '0');         // ASCII version - and output it
-    Append(Output, ASCIIDigit);
-    Param = Param - (Digit * Divisor);        // get remainder
-    Divisor = Divisor / 10;                   // set for next digit
-  }
-  ASCIIDigit = (char)(Param + '0');           // ASCII version of units digit
-  Append(Output, ASCIIDigit);
-  strcat(Output, ";");
+  FormatDigits(&Fmt, Param, CharCount);
+  FormatChar(&Fmt, ';');
   SendCATMessage(Output);
 }
 
@@ -402,13 +365,15 @@ void MakeCATMessageNumeric(ECATCommands Cmd, long Param)
 void MakeCATMessageBool(ECATCommands Cmd, bool Param) 
 {
   SCATCommands* StructPtr;
+  SFormatter Fmt;
 
   StructPtr = GCATCommands + (byte)Cmd;
-  strcpy(Output, StructPtr->CATString);               // copy the base message
+  FormatBegin(&Fmt, Output, sizeof(Output));
+  FormatLiteral(&Fmt, StructPtr->CATString);          // copy the base message
   if (Param)
-    strcat(Output, "1;");
+    FormatLiteral(&Fmt, "1;");
   else
-    strcat(Output, "0;");
+    FormatLiteral(&Fmt, "0;");
   SendCATMessage(Output);
 }
 
@@ -418,29 +383,18 @@ void MakeCATMessageBool(ECATCommands Cmd, bool Param)
 // make a CAT command with a string parameter
 // the string is truncated if too long, or padded with spaces if too short
 //
-void MakeCATMessageString(ECATCommands Cmd, char* Param) 
+void MakeCATMessageString(ECATCommands Cmd, const char* Param) 
 {
-  byte ParamLength, ReqdLength;                        // string lengths
   SCATCommands* StructPtr;
-  byte Cntr;
+  SFormatter Fmt;
 
   StructPtr = GCATCommands + (byte)Cmd;
-  ParamLength = strlen(Param);                        // length of input string
-  ReqdLength = StructPtr->NumParams;                  // required length of parameter "nnnn" string not including semicolon
-  
-  strcpy(Output, StructPtr->CATString);               // copy the base message
-  if(ParamLength > ReqdLength)                        // if string too long, truncate it
-    Param[ReqdLength]=0; 
-  strcat(Output, Param);                              // append the string
-//
-// now see if we need to pad
-//
-  if (ParamLength < ReqdLength)
-  for (Cntr=0; Cntr < (ReqdLength-ParamLength); Cntr++)
-    strcat(Output, " ");
+  FormatBegin(&Fmt, Output, sizeof(Output));
+  FormatLiteral(&Fmt, StructPtr->CATString);          // copy the base message
+  FormatPadded(&Fmt, Param, StructPtr->ReplyLength);  // append the string, truncated or padded to length
 //
 // finally terminate and send  
 //
-  strcat(Output, ";");                                // add the terminating semicolon
+  FormatChar(&Fmt, ';');                              // add the terminating semicolon
   SendCATMessage(Output);
 }
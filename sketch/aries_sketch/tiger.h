@@ -31,6 +31,11 @@ enum ECATCommands
   eZZOV,                          // ATU enable (from PC to Arduino)
   eZZOY,                          // ATU Quick Tune Enable
   eZZZS,                          // s/w version
+  eZZOS,                          // ATU status query and reply
+  eZZOT,                          // ATU status report interval (ms; 0 = off)
+  eZZOD,                          // tune trace dump (request N tunes; trace records reply)
+  eZZOG,                          // tuning strategy select and query
+  eZZOR,                          // cancelled tune resume time (s; 0 = never resume)
   eNoCommand                      // this is an exception condition
 };
 
@@ -56,6 +61,7 @@ struct SCATCommands
   long MaxParamValue;             // eg "9999"
   byte NumParams;                 // number of parameter bytes in a "set" command
   bool AlwaysSigned;              // true if the param version should always have a sign
+  byte ReplyLength;               // number of characters in a string reply (MakeCATMessageString)
 };
 
 
@@ -106,7 +112,7 @@ void MakeCATMessageBool(ECATCommands Cmd, bool Param);
 // make a CAT command with a string parameter
 // the string is truncated if too long, or padded with spaces if too short
 //
-void MakeCATMessageString(ECATCommands Cmd, char* Param);
+void MakeCATMessageString(ECATCommands Cmd, const char* Param);
 
 
 
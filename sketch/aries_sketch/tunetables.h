@@ -0,0 +1,54 @@
+/////////////////////////////////////////////////////////////////////////
+//
+// Aries ATU controller sketch by Laurence Barker G8NJJ
+// this sketch controls an L-match ATU network
+// with a CAT interface to connect to an HPSDR control program
+// copyright (c) Laurence Barker G8NJJ 2019
+//
+// the code is written for an Arduino Nano 33 IoT module
+//
+// tunetables.h: frequency dependent tables for the tune algorithm
+// the band descriptors; the tables themselves are generated from these by tablegen.h
+// this file can be replaced by the output of tools/tunetable
+/////////////////////////////////////////////////////////////////////////
+#ifndef __tunetables_h
+#define __tunetables_h
+
+
+//
+// band descriptors: one row per amateur band, with general coverage rows between.
+// the GTuneParamArray row is found by binary search on FreqMax (10KHz units),
+// so rows must be in ascending frequency order.
+// each band row has its own set of stage 1 sweeps; general coverage rows (#tries=0) use the band below.
+// the entire algorithm can be changed by replacing this table
+//
+#define VNUMTUNEROWS 22               // this tells how far to step
+constexpr SBandDescriptor GBandDescriptors[VNUMTUNEROWS] = 
+// FMax, Lmax, Cmax, #tries, S1Max, S1Step, S1Fixed, S1bStep, S2Mid+-, S2MidStep, S2Fine+- 
+{
+  {200, 255, 255, 3, 255, 24, 48, 24, 32, 4, 8},    // 160m band: 1.8-2MHz
+  {349, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},              // general coverage 2-3.5MHz: 160m sweeps and parameters
+  {400, 255, 255, 3, 255, 24, 36, 24, 32, 4, 8},    // 80m band: 3.5-4MHz
+  {524, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},              // general coverage 4-5.25MHz: 80m sweeps and parameters
+  {545, 255, 255, 3, 240, 22, 27, 18, 28, 4, 8},    // 60m band: 5.25-5.45MHz
+  {699, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},              // general coverage 5.45-7MHz: 60m sweeps and parameters
+  {730, 210, 210, 3, 210, 20, 18, 12, 24, 4, 8},    // 40m band: 7-7.3MHz
+  {1009, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},             // general coverage 7.3-10.1MHz: 40m sweeps and parameters
+  {1015, 150, 150, 3, 150, 14, 18, 9, 16, 3, 8},    // 30m band: 10.1-10.15MHz
+  {1399, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},             // general coverage 10.15-14MHz: 30m sweeps and parameters
+  {1435, 100, 100, 3, 100, 10, 18, 6, 12, 2, 8},    // 20m band: 14-14.35MHz
+  {1806, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},             // general coverage 14.35-18.07MHz: 20m sweeps and parameters
+  {1817, 80, 80, 3, 75, 7, 12, 4, 10, 2, 8},        // 17m band: 18.07-18.17MHz
+  {2099, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},             // general coverage 18.17-21MHz: 17m sweeps and parameters
+  {2145, 60, 60, 3, 55, 5, 8, 3, 8, 1, 8},          // 15m band: 21-21.45MHz
+  {2488, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},             // general coverage 21.45-24.89MHz: 15m sweeps and parameters
+  {2499, 60, 60, 3, 55, 5, 8, 3, 8, 1, 8},          // 12m band: 24.89-24.99MHz
+  {2799, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},             // general coverage 24.99-28MHz: 12m sweeps and parameters
+  {2970, 60, 60, 3, 55, 5, 8, 3, 8, 1, 8},          // 10m band: 28-29.7MHz
+  {4999, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},             // general coverage 29.7-50MHz: 10m sweeps and parameters
+  {5400, 30, 30, 3, 20, 2, 3, 2, 8, 1, 8},          // 6m band: 50-54MHz
+  {65535, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},            // general coverage above 54MHz: 6m sweeps and parameters
+};
+
+
+#endif
@@ -0,0 +1,419 @@
+/////////////////////////////////////////////////////////////////////////
+//
+// Aries ATU controller sketch by Laurence Barker G8NJJ
+// this sketch controls an L-match ATU network
+// with a CAT interface to connect to an HPSDR control program
+// copyright (c) Laurence Barker G8NJJ 2019
+//
+// formatbench.cpp: host benchmark for the text formatter (sketch/aries_sketch/formatter.cpp)
+//
+// the display and CAT strings used to be made with mysprintf() and strcpy/strcat,
+// and the CAT digits with Append() (a strlen() per character). Those are copied
+// here unchanged as the "old" code; each test builds the same string the old and
+// new way, checks they are identical over a range of values, then times both.
+// the timings are for the PC, not the SAMD21: the ratio is what matters.
+//
+// build (from this directory):
+//   g++ -O2 -std=gnu++11 -Ihost -I../../sketch/aries_sketch formatbench.cpp -o formatbench
+// run:
+//   ./formatbench [iterations]
+/////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+#include "formatter.cpp"
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+// old code, as it was in LCD_UI.cpp and tiger.cpp
+//
+/////////////////////////////////////////////////////////////////////////
+
+unsigned char mysprintf(char *dest, int Value, bool AddDP)
+{
+  unsigned char Digit;              // calculated digit
+  bool HadADigit = false;           // true when found a non zero digit
+  unsigned char DigitCount = 0;     // number of returned digits
+  unsigned int Divisor = 10000;     // power of 10 being calculated
+
+  if (Value < 0)
+  {
+    *dest++ = '-';    // add to output
+    DigitCount++;
+    Value = -Value;
+  }
+  while (Divisor >= 10)
+  {
+    Digit = Value / Divisor;        // find digit: integer divide
+    if (Digit != 0)
+      HadADigit = true;             // flag if non zero so all trailing digits added
+    if (HadADigit)                  // if 1st non zero or all subsequent
+    {
+      *dest++ = Digit + VASCII0;    // add to output
+      DigitCount++;
+    }
+    Value -= (Digit * Divisor);     // get remainder from divide
+    Divisor = Divisor / 10;         // ready for next digit
+  }
+  if (AddDP)
+  {
+    if (HadADigit == false)
+    {
+      *dest++ = '0';
+      DigitCount++;
+    }
+    *dest++ = '.';
+  DigitCount++;
+  }
+  *dest++ = Value + VASCII0;
+  DigitCount++;
+  *dest++ = 0;
+
+  return DigitCount;
+}
+
+
+long DivisorTable[] =
+{
+  0, 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+
+void Append(char* s, char ch)
+{
+  byte len;
+
+  len = strlen(s);
+  s[len++] = ch;
+  s[len] = 0;
+}
+
+
+void OldBatchValue(char* Str, const char* Attribute, int Value)
+{
+  char Str2[10];
+
+  mysprintf(Str2, Value, false);
+  strcpy(Str, Attribute);
+  strcat(Str, "=");
+  strcat(Str, Str2);
+}
+
+
+void OldFixedText(char* Str, const char* Attribute, int Value)
+{
+  char Str2[10];
+
+  mysprintf(Str2, Value, true);
+  strcpy(Str, Attribute);
+  strcat(Str, "=\"");
+  strcat(Str, Str2);
+  strcat(Str, "\"");
+}
+
+
+void OldNeedleLine(char* Str, int X1, int Y1, int X2, int Y2)
+{
+  char Str2[10];
+
+  strcpy(Str, "line ");
+  mysprintf(Str2, X1, false);
+  strcat(Str, Str2);
+  strcat(Str, ",");
+  mysprintf(Str2, Y1, false);
+  strcat(Str, Str2);
+  strcat(Str, ",");
+  mysprintf(Str2, X2, false);
+  strcat(Str, Str2);
+  strcat(Str, ",");
+  mysprintf(Str2, Y2, false);
+  strcat(Str, Str2);
+  strcat(Str, ",BLUE");
+}
+
+
+void OldCATNumeric(char* Output, const char* CATString, long Param, byte CharCount, bool AlwaysSigned)
+{
+  unsigned long Divisor;
+  unsigned long Digit;
+
+  strcpy(Output, CATString);
+  if (AlwaysSigned)
+  {
+    if (Param < 0)
+    {
+      strcat(Output, "-");
+      Param = -Param;
+    }
+    else
+      strcat(Output, "+");
+    CharCount--;
+  }
+  else if (Param < 0)
+  {
+      strcat(Output, "-");
+      Param = -Param;
+      CharCount--;
+  }
+  Divisor = DivisorTable[CharCount];
+  while (Divisor > 1)
+  {
+    Digit = Param / Divisor;
+    Append(Output, (char)(Digit + '0'));
+    Param = Param - (Digit * Divisor);
+    Divisor = Divisor / 10;
+  }
+  Append(Output, (char)(Param + '0'));
+  strcat(Output, ";");
+}
+
+
+void OldCATString(char* Output, const char* CATString, char* Param, byte ReqdLength)
+{
+  byte ParamLength;
+  byte Cntr;
+
+  ParamLength = strlen(Param);
+  strcpy(Output, CATString);
+  if(ParamLength > ReqdLength)
+    Param[ReqdLength]=0;
+  strcat(Output, Param);
+  if (ParamLength < ReqdLength)
+  for (Cntr=0; Cntr < (ReqdLength-ParamLength); Cntr++)
+    strcat(Output, " ");
+  strcat(Output, ";");
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+// new code, as now in LCD_UI.cpp and tiger.cpp
+//
+/////////////////////////////////////////////////////////////////////////
+
+void NewBatchValue(char* Str, const char* Attribute, int Value)
+{
+  SFormatter Fmt;
+
+  FormatBegin(&Fmt, Str, 40);
+  FormatLiteral(&Fmt, Attribute);
+  FormatChar(&Fmt, '=');
+  FormatInt(&Fmt, Value);
+}
+
+
+void NewFixedText(char* Str, const char* Attribute, int Value)
+{
+  SFormatter Fmt;
+
+  FormatBegin(&Fmt, Str, 40);
+  FormatLiteral(&Fmt, Attribute);
+  FormatLiteral(&Fmt, "=\"");
+  FormatFixed(&Fmt, Value, 1);
+  FormatChar(&Fmt, '"');
+}
+
+
+void NewNeedleLine(char* Str, int X1, int Y1, int X2, int Y2)
+{
+  SFormatter Fmt;
+
+  FormatBegin(&Fmt, Str, 40);
+  FormatLiteral(&Fmt, "line ");
+  FormatInt(&Fmt, X1);
+  FormatChar(&Fmt, ',');
+  FormatInt(&Fmt, Y1);
+  FormatChar(&Fmt, ',');
+  FormatInt(&Fmt, X2);
+  FormatChar(&Fmt, ',');
+  FormatInt(&Fmt, Y2);
+  FormatLiteral(&Fmt, ",BLUE");
+}
+
+
+void NewCATNumeric(char* Output, const char* CATString, long Param, byte CharCount, bool AlwaysSigned)
+{
+  SFormatter Fmt;
+
+  FormatBegin(&Fmt, Output, 40);
+  FormatLiteral(&Fmt, CATString);
+  if (AlwaysSigned)
+  {
+    if (Param < 0)
+    {
+      FormatChar(&Fmt, '-');
+      Param = -Param;
+    }
+    else
+      FormatChar(&Fmt, '+');
+    CharCount--;
+  }
+  else if (Param < 0)
+  {
+      FormatChar(&Fmt, '-');
+      Param = -Param;
+      CharCount--;
+  }
+  FormatDigits(&Fmt, Param, CharCount);
+  FormatChar(&Fmt, ';');
+}
+
+
+void NewCATString(char* Output, const char* CATString, char* Param, byte ReqdLength)
+{
+  SFormatter Fmt;
+
+  FormatBegin(&Fmt, Output, 40);
+  FormatLiteral(&Fmt, CATString);
+  FormatPadded(&Fmt, Param, ReqdLength);
+  FormatChar(&Fmt, ';');
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+// tests
+//
+/////////////////////////////////////////////////////////////////////////
+
+int GFailures;
+volatile unsigned int GSink;                // stops the compiler removing the timed code
+
+
+void Compare(const char* Test, long Value, const char* Old, const char* New)
+{
+  if(strcmp(Old, New) != 0)
+  {
+    if(GFailures++ < 10)
+      printf("%s(%ld): old \"%s\" new \"%s\"\n", Test, Value, Old, New);
+  }
+}
+
+
+//
+// CAT string test: the old code truncates its parameter in place, so each gets a copy
+//
+const char* GCATStrings[] = {"", "ATU Tuned", "01234567890123456789012345", "0123456789012345678901234567890"};
+
+
+void CheckAll(void)
+{
+  char Old[40], New[40], Param[40];
+  long Value;
+  int X;
+  unsigned int Cntr;
+
+  for(Value = -99999; Value <= 99999; Value++)
+  {
+    OldBatchValue(Old, "p2j0.val", Value);
+    NewBatchValue(New, "p2j0.val", Value);
+    Compare("BatchValue", Value, Old, New);
+    OldFixedText(Old, "p4t3.txt", Value);
+    NewFixedText(New, "p4t3.txt", Value);
+    Compare("FixedText", Value, Old, New);
+  }
+  for(X = 0; X < 320; X++)
+  {
+    OldNeedleLine(Old, 10, 230, X, 230 - X / 2);
+    NewNeedleLine(New, 10, 230, X, 230 - X / 2);
+    Compare("NeedleLine", X, Old, New);
+  }
+  for(Value = -9999; Value <= 9999999; Value += (Value < 10000) ? 1 : 997)
+  {
+    OldCATNumeric(Old, "ZZZS", Value, 7, false);
+    NewCATNumeric(New, "ZZZS", Value, 7, false);
+    Compare("CATNumeric", Value, Old, New);
+    OldCATNumeric(Old, "ZZZS", Value, 8, true);
+    NewCATNumeric(New, "ZZZS", Value, 8, true);
+    Compare("CATNumericSigned", Value, Old, New);
+  }
+  for(Cntr = 0; Cntr < sizeof(GCATStrings) / sizeof(GCATStrings[0]); Cntr++)
+  {
+    strcpy(Param, GCATStrings[Cntr]);
+    OldCATString(Old, "ZZOS", Param, 26);
+    strcpy(Param, GCATStrings[Cntr]);
+    NewCATString(New, "ZZOS", Param, 26);
+    Compare("CATString", Cntr, Old, New);
+  }
+}
+
+
+//
+// time Iterations calls of a string builder taking a value
+//
+typedef void (*TBuilder)(char* Str, long Value);
+
+double TimeBuilder(TBuilder Builder, long Iterations)
+{
+  char Str[40];
+  long Cntr;
+
+  auto Start = std::chrono::steady_clock::now();
+  for(Cntr = 0; Cntr < Iterations; Cntr++)
+  {
+    Builder(Str, Cntr & 0x3FF);
+    GSink += Str[7];
+  }
+  auto End = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(End - Start).count() / Iterations;
+}
+
+
+void OldValue(char* Str, long Value)     { OldBatchValue(Str, "p2j0.val", Value); }
+void NewValue(char* Str, long Value)     { NewBatchValue(Str, "p2j0.val", Value); }
+void OldFixed(char* Str, long Value)     { OldFixedText(Str, "p4t3.txt", Value); }
+void NewFixed(char* Str, long Value)     { NewFixedText(Str, "p4t3.txt", Value); }
+void OldLine(char* Str, long Value)      { OldNeedleLine(Str, 10, 230, Value & 0xFF, 200 - (Value & 0x7F)); }
+void NewLine(char* Str, long Value)      { NewNeedleLine(Str, 10, 230, Value & 0xFF, 200 - (Value & 0x7F)); }
+void OldNumeric(char* Str, long Value)   { OldCATNumeric(Str, "ZZZS", Value * 997, 7, false); }
+void NewNumeric(char* Str, long Value)   { NewCATNumeric(Str, "ZZZS", Value * 997, 7, false); }
+void OldStatus(char* Str, long Value)    { char Param[] = "ATU Tuned"; OldCATString(Str, "ZZOS", Param, 26); }
+void NewStatus(char* Str, long Value)    { char Param[] = "ATU Tuned"; NewCATString(Str, "ZZOS", Param, 26); }
+
+
+struct SBenchmark
+{
+  const char* Name;
+  TBuilder Old;
+  TBuilder New;
+};
+
+SBenchmark GBenchmarks[] =
+{
+  {"BatchValue  p2j0.val=N", OldValue, NewValue},
+  {"BatchText   p4t3.txt=\"N.N\"", OldFixed, NewFixed},
+  {"needle line", OldLine, NewLine},
+  {"CAT numeric ZZZSnnnnnnn;", OldNumeric, NewNumeric},
+  {"CAT string  ZZOS (26 chars)", OldStatus, NewStatus}
+};
+
+
+int main(int argc, char** argv)
+{
+  long Iterations = 2000000;
+  unsigned int Cntr;
+  double OldTime, NewTime;
+
+  if(argc > 1)
+    Iterations = atol(argv[1]);
+
+  CheckAll();
+  if(GFailures != 0)
+  {
+    printf("%d mismatches between old and new formatting\n", GFailures);
+    return 1;
+  }
+  printf("old and new formatting identical\n\n");
+
+  printf("%-30s %10s %10s %8s\n", "test", "old ns", "new ns", "speedup");
+  for(Cntr = 0; Cntr < sizeof(GBenchmarks) / sizeof(GBenchmarks[0]); Cntr++)
+  {
+    OldTime = TimeBuilder(GBenchmarks[Cntr].Old, Iterations);
+    NewTime = TimeBuilder(GBenchmarks[Cntr].New, Iterations);
+    printf("%-30s %10.1f %10.1f %7.2fx\n", GBenchmarks[Cntr].Name, OldTime, NewTime, OldTime / NewTime);
+  }
+  return 0;
+}
@@ -0,0 +1,14 @@
+//
+// Aries ATU formatter benchmark
+// minimal host replacement for the Arduino core header,
+// enough to build formatter.cpp on a PC
+//
+#ifndef __host_arduino_h
+#define __host_arduino_h
+
+#include <stdint.h>
+#include <string.h>
+
+typedef uint8_t byte;
+
+#endif
@@ -0,0 +1,69 @@
+//
+// Aries ATU Nextion emulator
+// minimal host replacement for the Arduino core header, enough to build
+// LCD_UI.cpp and the Nextion library on a PC.
+// the clock is simulated, and Serial1 (the display link) is connected to the
+// emulated display: see nextionemu.cpp
+//
+#ifndef __host_arduino_h
+#define __host_arduino_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A6 20
+#define A7 21
+
+#ifndef min
+#define min(a,b) ((a)<(b)?(a):(b))
+#define max(a,b) ((a)>(b)?(a):(b))
+#endif
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+
+
+//
+// serial port: Serial discards debug output; Serial1 is the display link
+//
+class HardwareSerial
+{
+  public:
+    void begin(long Baud);
+    int available(void);
+    int read(void);
+    int availableForWrite(void);
+    size_t write(uint8_t Ch);
+    void flush(void);
+    size_t print(const char*) {return 0;}
+    size_t print(long) {return 0;}
+    size_t println(void) {return 0;}
+    size_t println(const char*) {return 0;}
+    size_t println(long) {return 0;}
+    operator bool() {return true;}
+};
+extern HardwareSerial Serial, Serial1;
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void pinMode(int Pin, int Mode);
+int digitalRead(int Pin);
+void digitalWrite(int Pin, int Value);
+inline void noInterrupts(void) {}
+inline void interrupts(void) {}
+
+#endif
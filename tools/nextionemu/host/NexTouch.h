@@ -0,0 +1,51 @@
+//
+// Aries ATU Nextion emulator
+// host version of the ITEAD library touch component base classes
+// (the library files the sketch changes are built unaltered from "nextion display/arduino_library_update")
+//
+#ifndef __NEXTOUCH_H__
+#define __NEXTOUCH_H__
+
+#include <Arduino.h>
+
+#define NEX_EVENT_PUSH  (0x01)
+#define NEX_EVENT_POP   (0x00)
+
+typedef void (*NexTouchEventCb)(void *ptr);
+
+
+class NexObject
+{
+  public:
+    NexObject(uint8_t pid, uint8_t cid, const char *name) : __pid(pid), __cid(cid), __name(name) {}
+
+  protected:
+    uint8_t getObjPid(void) {return __pid;}
+    uint8_t getObjCid(void) {return __cid;}
+    const char *getObjName(void) {return __name;}
+
+  private:
+    uint8_t __pid;
+    uint8_t __cid;
+    const char *__name;
+};
+
+
+class NexTouch : public NexObject
+{
+  public:
+    static void iterate(NexTouch **list, uint8_t pid, uint8_t cid, int32_t event);
+    NexTouch(uint8_t pid, uint8_t cid, const char *name);
+    void attachPush(NexTouchEventCb push, void *ptr = NULL);
+    void attachPop(NexTouchEventCb pop, void *ptr = NULL);
+
+  private:
+    void push(void);
+    void pop(void);
+    NexTouchEventCb __cb_push;
+    void *__cbpush_ptr;
+    NexTouchEventCb __cb_pop;
+    void *__cbpop_ptr;
+};
+
+#endif
@@ -0,0 +1,50 @@
+//
+// Aries ATU Nextion emulator
+// host version of the ITEAD library components used by LCD_UI.cpp
+//
+#ifndef __NEXTION_H__
+#define __NEXTION_H__
+
+#include <Arduino.h>
+#include "NexHardware.h"
+#include "NexTouch.h"
+
+
+class NexPage : public NexTouch
+{
+  public:
+    NexPage(uint8_t pid, uint8_t cid, const char *name) : NexTouch(pid, cid, name) {}
+    bool show(void);
+};
+
+class NexText : public NexTouch
+{
+  public:
+    NexText(uint8_t pid, uint8_t cid, const char *name) : NexTouch(pid, cid, name) {}
+};
+
+class NexButton : public NexTouch
+{
+  public:
+    NexButton(uint8_t pid, uint8_t cid, const char *name) : NexTouch(pid, cid, name) {}
+};
+
+class NexPicture : public NexTouch
+{
+  public:
+    NexPicture(uint8_t pid, uint8_t cid, const char *name) : NexTouch(pid, cid, name) {}
+};
+
+class NexProgressBar : public NexObject
+{
+  public:
+    NexProgressBar(uint8_t pid, uint8_t cid, const char *name) : NexObject(pid, cid, name) {}
+};
+
+class NexGauge : public NexObject
+{
+  public:
+    NexGauge(uint8_t pid, uint8_t cid, const char *name) : NexObject(pid, cid, name) {}
+};
+
+#endif
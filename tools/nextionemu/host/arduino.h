@@ -0,0 +1,4 @@
+//
+// Aries ATU Nextion emulator: the sketch includes the core header with either case
+//
+#include "Arduino.h"
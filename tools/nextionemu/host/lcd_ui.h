@@ -0,0 +1,4 @@
+//
+// Aries ATU Nextion emulator: LCD_UI.cpp includes its header with either case
+//
+#include "LCD_UI.h"
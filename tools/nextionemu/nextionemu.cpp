@@ -0,0 +1,916 @@
+/////////////////////////////////////////////////////////////////////////
+//
+// Aries ATU controller sketch by Laurence Barker G8NJJ
+// this sketch controls an L-match ATU network
+// with a CAT interface to connect to an HPSDR control program
+// copyright (c) Laurence Barker G8NJJ 2019
+//
+// nextionemu.cpp: host emulator for the Nextion display, to test LCD_UI.cpp without one
+//
+// LCD_UI.cpp and the Nextion library (nextion display/arduino_library_update) are built
+// into this program unchanged, with a host Arduino core. Serial1 is connected to an
+// emulated display: the UART runs in simulated time at the baud rate set, and the
+// display parses the command stream, keeps the state of each page's components,
+// answers bkcmd acknowledgements and sends the page load and touch events.
+// the link rate negotiation is run at power on, at power on with the rate saved, and after a
+// processor reset.
+// the ATU is replaced by a simple model driven by a script: receive, transmit and
+// tune on each page, moving between pages with touch events, then a PA trip.
+//
+// for each phase of the script it reports the serial bytes and commands per tick,
+// so display traffic changes can be measured, and the longest time the ATU status shown
+// was out of date; and it checks for commands the display would reject (eg a component
+// not on the current page), pages not reached and a status shown late.
+// the exit code is 1 if any check failed.
+//
+// build (from this directory):
+//   g++ -O2 -std=gnu++11 -Ihost -I../../sketch/aries_sketch -I"../../nextion display/arduino_library_update" nextionemu.cpp -o nextionemu
+// run:
+//   ./nextionemu [-n ticks per phase] [-l panel limit baud] [-c] [-v]
+//   -c lists every command received by the display; -v shows the component values at the end of each phase
+//   -l sets the fastest rate the display accepts, to test the baud rate fallback
+/////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <string>
+#include <map>
+#include <deque>
+
+#include "LCD_UI.cpp"
+#include "formatter.cpp"
+#include "pushbutton.cpp"
+#include "mechencoder.cpp"
+#include "NexHardware.cpp"
+
+
+#define VTICKNANOS 16000000ULL          // main tick period (16ms)
+#define VSERVICENANOS 100000ULL         // main loop period between ticks (LCD_UI_Service)
+#define VPOLLNANOS 1000ULL              // simulated time taken by a poll of the clock or serial port
+#define VUARTBUFFER 64                  // Arduino core serial transmit buffer
+#define VHMIPAGES 7                     // pages in the display HMI file
+#define VMAXERRORS 20                   // error messages kept for the report
+#define VMAXSTATUSTICKS 20              // longest the status shown may be out of date (ticks)
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+// simulated clock and I/O pins
+//
+/////////////////////////////////////////////////////////////////////////
+
+unsigned long long GNanos;              // simulated time
+
+
+unsigned long millis(void)
+{
+  GNanos += VPOLLNANOS;
+  return GNanos / 1000000ULL;
+}
+
+
+unsigned long micros(void)
+{
+  GNanos += VPOLLNANOS;
+  return GNanos / 1000ULL;
+}
+
+
+void delay(unsigned long ms)
+{
+  GNanos += ms * 1000000ULL;
+}
+
+
+void pinMode(int Pin, int Mode) {}
+int digitalRead(int Pin) {return HIGH;}
+void digitalWrite(int Pin, int Value) {}
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+// emulated display
+//
+/////////////////////////////////////////////////////////////////////////
+
+struct SDisplay
+{
+  int Page;                                             // current page
+  int BkCmd;                                            // acknowledgement level
+  unsigned long Baud;                                   // link rate
+  std::map<std::string, std::string> Values[VHMIPAGES]; // component attributes written on each page
+  std::string Command;                                  // command being received
+  int FFCount;                                          // 0xFF terminators received
+  bool Garbled;                                         // command includes bytes received at the wrong rate
+};
+
+SDisplay GDisplay;
+
+//
+// statistics for the phase being run
+//
+struct SStats
+{
+  unsigned long Bytes;                  // bytes sent to the display
+  unsigned long Commands;               // commands executed by the display
+  unsigned long Draws;                  // drawing commands ("ref", "line" etc)
+  unsigned int TickBytes, TickCommands; // this tick
+  unsigned int MaxTickBytes, MaxTickCommands;
+  unsigned int LateTicks;               // ticks whose processing overran the tick period
+  unsigned int MaxStatusTicks;          // longest the status shown was out of date (ticks)
+};
+
+SStats GStats;
+int GErrors;
+std::string GErrorMessages[VMAXERRORS];
+bool GListCommands;
+unsigned long GTick;
+unsigned int GStatusTicks;              // ticks the status shown has been out of date
+
+
+void Error(const std::string& Message)
+{
+  if(GErrors < VMAXERRORS)
+    GErrorMessages[GErrors] = Message;
+  GErrors++;
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+// serial link
+// bytes are delivered when their time on the wire has passed; a byte sent at
+// a different rate from the receiver's is received as garbage
+//
+/////////////////////////////////////////////////////////////////////////
+
+struct SLinkByte
+{
+  byte Value;
+  unsigned long long Time;              // time the last bit arrives
+  unsigned long Baud;                   // rate it was sent at
+};
+
+std::deque<SLinkByte> GToDisplay;       // MCU to display, including the UART transmit buffer
+std::deque<SLinkByte> GFromDisplay;     // display to MCU
+unsigned long GMCUBaud = 115200;        // Serial1 rate
+unsigned long GPanelLimit = 921600;     // fastest rate the display accepts
+unsigned long long GToDisplayEnd, GFromDisplayEnd;    // time the last byte queued each way is sent
+
+HardwareSerial Serial, Serial1;
+
+void DisplayReceive(byte Ch);
+
+
+//
+// time per byte (10 bits) on the wire
+//
+unsigned long long ByteNanos(unsigned long Baud)
+{
+  return 10000000000ULL / Baud;
+}
+
+
+//
+// the byte received: garbage if the rates don't match
+//
+byte ReceivedByte(const SLinkByte& Sent, unsigned long Baud)
+{
+  if(Sent.Baud != Baud)
+    return 0x00;
+  return Sent.Value;
+}
+
+
+//
+// deliver the bytes that have reached the display
+//
+void UpdateLink(void)
+{
+  while(!GToDisplay.empty() && (GToDisplay.front().Time <= GNanos))
+  {
+    byte Ch = ReceivedByte(GToDisplay.front(), GDisplay.Baud);
+    if((Ch == 0x00) && (GToDisplay.front().Value != 0x00))
+      GDisplay.Garbled = true;
+    GToDisplay.pop_front();
+    DisplayReceive(Ch);
+  }
+}
+
+
+//
+// send bytes from the display to the MCU
+//
+void DisplaySend(const byte* Bytes, int Length)
+{
+  int Cntr;
+
+  for(Cntr = 0; Cntr < Length; Cntr++)
+  {
+    GFromDisplayEnd = ((GFromDisplayEnd > GNanos) ? GFromDisplayEnd : GNanos) + ByteNanos(GDisplay.Baud);
+    GFromDisplay.push_back(SLinkByte{Bytes[Cntr], GFromDisplayEnd, GDisplay.Baud});
+  }
+}
+
+
+void HardwareSerial::begin(long Baud)
+{
+  if(this == &Serial1)
+    GMCUBaud = Baud;
+}
+
+
+int HardwareSerial::available(void)
+{
+  int Count = 0;
+
+  if(this != &Serial1)
+    return 0;
+  GNanos += VPOLLNANOS;
+  UpdateLink();
+  while((Count < (int)GFromDisplay.size()) && (GFromDisplay[Count].Time <= GNanos))
+    Count++;
+  return Count;
+}
+
+
+int HardwareSerial::read(void)
+{
+  byte Ch;
+
+  if((this != &Serial1) || GFromDisplay.empty() || (GFromDisplay.front().Time > GNanos))
+    return -1;
+  Ch = ReceivedByte(GFromDisplay.front(), GMCUBaud);
+  GFromDisplay.pop_front();
+  return Ch;
+}
+
+
+int HardwareSerial::availableForWrite(void)
+{
+  if(this != &Serial1)
+    return VUARTBUFFER;
+  GNanos += VPOLLNANOS;
+  UpdateLink();
+  return VUARTBUFFER - (int)GToDisplay.size();
+}
+
+
+size_t HardwareSerial::write(uint8_t Ch)
+{
+  if(this != &Serial1)
+    return 1;
+  GToDisplayEnd = ((GToDisplayEnd > GNanos) ? GToDisplayEnd : GNanos) + ByteNanos(GMCUBaud);
+  GToDisplay.push_back(SLinkByte{Ch, GToDisplayEnd, GMCUBaud});
+  GStats.Bytes++;
+  GStats.TickBytes++;
+  return 1;
+}
+
+
+//
+// wait until everything written has been sent
+//
+void HardwareSerial::flush(void)
+{
+  if((this == &Serial1) && (GNanos < GToDisplayEnd))
+    GNanos = GToDisplayEnd;
+  UpdateLink();
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+// display command processing
+//
+/////////////////////////////////////////////////////////////////////////
+
+//
+// return codes, as NexHardware.cpp
+//
+void DisplayReturn(byte Code)
+{
+  byte Frame[4] = {Code, 0xFF, 0xFF, 0xFF};
+  DisplaySend(Frame, 4);
+}
+
+
+//
+// send a touch event: the HMI has "send component ID" set on its pages and controls
+//
+void DisplayTouchEvent(int Page, int Component, bool Press)
+{
+  byte Frame[7] = {NEX_RET_EVENT_TOUCH_HEAD, (byte)Page, (byte)Component, (byte)(Press ? NEX_EVENT_PUSH : NEX_EVENT_POP), 0xFF, 0xFF, 0xFF};
+  DisplaySend(Frame, 7);
+}
+
+
+//
+// touch a control: press then release
+//
+void Touch(int Page, int Component)
+{
+  DisplayTouchEvent(Page, Component, true);
+  DisplayTouchEvent(Page, Component, false);
+}
+
+
+void CommandFailed(const std::string& Command, byte Code, const char* Reason)
+{
+  char Str[40];
+
+  if(!GDisplay.Garbled)                                 // expected while the rate is found
+  {
+    snprintf(Str, sizeof(Str), "tick %lu page %d: ", GTick, GDisplay.Page);
+    Error(std::string(Str) + Reason + ": \"" + Command + "\"");
+  }
+  if(GDisplay.BkCmd >= 2)
+    DisplayReturn(Code);
+}
+
+
+//
+// load a page: its components go back to their initial values, and the page's
+// preinitialise event tells the controller (each page sends a touch press of itself)
+//
+void LoadPage(int Page)
+{
+  GDisplay.Page = Page;
+  GDisplay.Values[Page].clear();
+  DisplayTouchEvent(Page, 0, true);
+}
+
+
+bool IsNumber(const std::string& Str)
+{
+  size_t Pos = (Str[0] == '-') ? 1 : 0;
+
+  if(Pos >= Str.size())
+    return false;
+  for(; Pos < Str.size(); Pos++)
+    if(!isdigit(Str[Pos]))
+      return false;
+  return true;
+}
+
+
+//
+// rates the display supports
+//
+bool IsValidBaud(unsigned long Baud)
+{
+  const unsigned long Rates[] = {2400, 4800, 9600, 19200, 31250, 38400, 57600, 115200, 230400, 250000, 256000, 512000, 921600};
+  unsigned int Cntr;
+
+  for(Cntr = 0; Cntr < sizeof(Rates) / sizeof(Rates[0]); Cntr++)
+    if(Rates[Cntr] == Baud)
+      return true;
+  return false;
+}
+
+
+//
+// execute one command
+//
+void DisplayExecute(const std::string& Command)
+{
+  size_t Equals, Dot;
+  std::string Name, Object, Attribute, Value;
+  int Page;
+  bool OK = true;
+
+  GStats.Commands++;
+  GStats.TickCommands++;
+  if(GListCommands)
+    printf("%6lu p%d: %s%s\n", GTick, GDisplay.Page, Command.c_str(), GDisplay.Garbled ? " (garbled)" : "");
+
+  Equals = Command.find('=');
+  if(Command.empty())                                   // sent by nexInit to clear the display's input
+    return;
+  else if(Command.compare(0, 5, "page ") == 0)
+  {
+    Name = Command.substr(5);
+    if(Name.compare(0, 4, "page") == 0)
+      Name = Name.substr(4);
+    Page = atoi(Name.c_str());
+    if(!IsNumber(Name) || (Page < 0) || (Page >= VHMIPAGES))
+    {
+      CommandFailed(Command, NEX_RET_INVALID_PAGE_ID, "invalid page");
+      return;
+    }
+    LoadPage(Page);
+  }
+  else if((Command.compare(0, 4, "ref ") == 0) || (Command.compare(0, 5, "line ") == 0)
+          || (Command.compare(0, 5, "fill ") == 0) || (Command == "cls"))
+    GStats.Draws++;
+  else if(Command == "sendme")
+  {
+    byte Frame[5] = {NEX_RET_CURRENT_PAGE_ID_HEAD, (byte)GDisplay.Page, 0xFF, 0xFF, 0xFF};
+    DisplaySend(Frame, 5);
+    return;
+  }
+  else if(Equals != std::string::npos)
+  {
+    Name = Command.substr(0, Equals);
+    Value = Command.substr(Equals + 1);
+    Dot = Name.find('.');
+    if(Dot == std::string::npos)                        // system variable
+    {
+      if(Name == "bkcmd")
+        GDisplay.BkCmd = atoi(Value.c_str());
+      else if(Name == "baud")
+      {
+        if(!IsValidBaud(atol(Value.c_str())))
+        {
+          CommandFailed(Command, NEX_RET_INVALID_BAUD, "invalid baud rate");
+          return;
+        }
+        if(atol(Value.c_str()) > (long)GPanelLimit)   // not supported by this display: expected
+        {
+          if(GDisplay.BkCmd >= 2)
+            DisplayReturn(NEX_RET_INVALID_BAUD);
+          return;
+        }
+        if((GDisplay.BkCmd == 1) || (GDisplay.BkCmd == 3))
+          DisplayReturn(NEX_RET_CMD_FINISHED);          // sent at the old rate
+        GDisplay.Baud = atol(Value.c_str());
+        return;
+      }
+      else if((Name != "dim") && (Name != "dims") && (Name != "bauds") && (Name != "thsp") && (Name != "thup"))
+        OK = false;
+    }
+    else
+    {
+//
+// the HMI names each component p<page>..., so its page can be checked
+//
+      Object = Name.substr(0, Dot);
+      Attribute = Name.substr(Dot + 1);
+      if((Object.size() < 3) || (Object[0] != 'p') || ((Object[1] - '0') != GDisplay.Page))
+      {
+        CommandFailed(Command, NEX_RET_INVALID_VARIABLE, "component not on this page");
+        return;
+      }
+      if(Attribute == "txt")
+        OK = (Value.size() >= 2) && (Value[0] == '"') && (Value[Value.size() - 1] == '"');
+      else
+        OK = IsNumber(Value);
+      if(OK)
+        GDisplay.Values[GDisplay.Page][Name] = Value;
+    }
+    if(!OK)
+    {
+      CommandFailed(Command, NEX_RET_INVALID_VARIABLE, "invalid assignment");
+      return;
+    }
+  }
+  else
+  {
+    CommandFailed(Command, NEX_RET_INVALID_CMD, "invalid instruction");
+    return;
+  }
+  if((GDisplay.BkCmd == 1) || (GDisplay.BkCmd == 3))
+    DisplayReturn(NEX_RET_CMD_FINISHED);
+}
+
+
+//
+// a byte has reached the display: assemble commands ending 0xFF 0xFF 0xFF
+//
+void DisplayReceive(byte Ch)
+{
+  if(Ch == 0xFF)
+  {
+    if(++GDisplay.FFCount == 3)
+    {
+      DisplayExecute(GDisplay.Command);
+      GDisplay.Command.clear();
+      GDisplay.FFCount = 0;
+      GDisplay.Garbled = false;
+    }
+  }
+  else
+  {
+    if(GDisplay.FFCount != 0)
+    {
+      if(!GDisplay.Garbled)
+        Error("command with a short terminator: \"" + GDisplay.Command + "\"");
+      GDisplay.Command.clear();
+      GDisplay.FFCount = 0;
+    }
+    GDisplay.Command += (char)Ch;
+  }
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+// host versions of the ITEAD library components
+//
+/////////////////////////////////////////////////////////////////////////
+
+NexTouch::NexTouch(uint8_t pid, uint8_t cid, const char *name) : NexObject(pid, cid, name)
+{
+  __cb_push = NULL;
+  __cbpush_ptr = NULL;
+  __cb_pop = NULL;
+  __cbpop_ptr = NULL;
+}
+
+
+void NexTouch::attachPush(NexTouchEventCb push, void *ptr)
+{
+  __cb_push = push;
+  __cbpush_ptr = ptr;
+}
+
+
+void NexTouch::attachPop(NexTouchEventCb pop, void *ptr)
+{
+  __cb_pop = pop;
+  __cbpop_ptr = ptr;
+}
+
+
+void NexTouch::push(void)
+{
+  if(__cb_push)
+    __cb_push(__cbpush_ptr);
+}
+
+
+void NexTouch::pop(void)
+{
+  if(__cb_pop)
+    __cb_pop(__cbpop_ptr);
+}
+
+
+void NexTouch::iterate(NexTouch **list, uint8_t pid, uint8_t cid, int32_t event)
+{
+  NexTouch *e;
+  uint16_t i;
+
+  if(list == NULL)
+    return;
+  for(i = 0; (e = list[i]) != NULL; i++)
+  {
+    if((e->getObjPid() == pid) && (e->getObjCid() == cid))
+    {
+      if(event == NEX_EVENT_PUSH)
+        e->push();
+      else if(event == NEX_EVENT_POP)
+        e->pop();
+      break;
+    }
+  }
+}
+
+
+bool NexPage::show(void)
+{
+  std::string Command = std::string("page ") + getObjName();
+
+  sendCommand(Command.c_str());
+  return recvRetCommandFinished();
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+// ATU model: the values shown are set by the script
+//
+/////////////////////////////////////////////////////////////////////////
+
+bool GATUEnabled = true;
+unsigned int GForwardPower;
+float GVSWR = 1.0;
+bool GIsTripped;
+byte GTripInputBits;
+unsigned int GPACurrent;
+volatile bool GPTTPressed;
+bool GQuickTuneEnabled;
+byte GTXAntenna = 1;
+bool GTuneActive;
+byte GTuneStrategy;
+unsigned int GTunedFrequency10 = 710;
+bool GValidSolution;
+byte GInductance = 40, GCapacitance = 60;
+bool GHiLoZ;
+byte GEEPage = 1;
+byte GEEDisplayBaud = 0xFF;
+
+void DriveSolution(void) {}
+void EEEraseSolutionSet(byte Antenna) {}
+byte EEReadPage() {return GEEPage;}
+bool EEReadPeak() {return false;}
+byte EEReadScale() {return 0;}
+void EEWriteEnabled(bool Value) {}
+void EEWritePage(byte Value) {GEEPage = Value;}
+void EEWritePeak(bool Value) {}
+void EEWriteQuick(bool Value) {}
+void EEWriteScale(byte Value) {}
+void EEWriteStrategy(byte Value) {}
+byte EEReadDisplayBaud() {return GEEDisplayBaud;}
+void EEWriteDisplayBaud(byte Value) {GEEDisplayBaud = Value;}
+void SetADCScaleFactor(byte DisplayScale) {}
+void SetATUOnOff(bool State) {GATUEnabled = State;}
+byte GetInductance(void) {return GInductance;}
+byte GetCapacitance(void) {return GCapacitance;}
+bool GetHiLoZ(void) {return GHiLoZ;}
+void SetInductance(byte Value) {GInductance = Value;}
+void SetCapacitance(byte Value) {GCapacitance = Value;}
+void SetHiLoZ(bool Value) {GHiLoZ = Value;}
+void SetTuneStrategy(byte Strategy) {GTuneStrategy = Strategy;}
+const char* GetTuneStrategyName(byte Strategy) {return "Table";}
+void TripResetPressed(void) {}
+
+
+unsigned int GetPowerReading(bool IsFwdPower)
+{
+  float Rho = (GVSWR - 1.0) / (GVSWR + 1.0);
+
+  if(IsFwdPower)
+    return GForwardPower;
+  else
+    return (unsigned int)(GForwardPower * Rho * Rho);
+}
+
+
+unsigned int FindPeakPower(bool IsFwdPower)
+{
+  return GetPowerReading(IsFwdPower);
+}
+
+
+void GetADCMeanAndPeak(bool IsVF, unsigned int* Mean, unsigned int* Peak)
+{
+  *Mean = (unsigned int)(sqrt((double)GetPowerReading(IsVF)) * 100);
+  *Peak = *Mean + *Mean / 4;
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+// script
+//
+/////////////////////////////////////////////////////////////////////////
+
+enum EPhaseAction
+{
+  eNoAction,
+  eTouchControl,                        // touch control Page/Component at the start
+  eTrip,                                // PA trip at the start
+  eClearTrip                            // remove the PA trip at the start
+};
+
+struct SPhase
+{
+  const char* Name;
+  EPhaseAction Action;
+  int Page, Component;                  // control to touch
+  bool PTT;                             // transmitting
+  bool Tune;                            // tune in progress
+  int ExpectedPage;                     // page the display should be on at the end
+};
+
+SPhase GScript[] =
+{
+  {"splash", eNoAction, 0, 0, false, false, 1},
+  {"x needle receive", eNoAction, 0, 0, false, false, 1},
+  {"x needle transmit", eNoAction, 0, 0, true, false, 1},
+  {"x needle tune", eNoAction, 0, 0, true, true, 1},
+  {"bargraph receive", eTouchControl, 1, 2, false, false, 2},           // p1DisplayBtn
+  {"bargraph transmit", eNoAction, 0, 0, true, false, 2},
+  {"bargraph tune", eNoAction, 0, 0, true, true, 2},
+  {"bargraph peak", eTouchControl, 2, 10, true, false, 2},              // p2PeakBtn
+  {"meter receive", eTouchControl, 2, 1, false, false, 3},              // p2DisplayBtn
+  {"meter transmit", eNoAction, 0, 0, true, false, 3},
+  {"meter tune", eNoAction, 0, 0, true, true, 3},
+  {"meter tuned", eNoAction, 0, 0, false, false, 3},
+  {"engineering receive", eTouchControl, 3, 3, false, false, 4},        // p3DisplayBtn
+  {"engineering transmit", eNoAction, 0, 0, true, false, 4},
+  {"engineering tune", eNoAction, 0, 0, true, true, 4},
+  {"engineering L+", eTouchControl, 4, 7, false, false, 4},             // p4LPlusBtn
+  {"trip", eTrip, 0, 0, false, false, 6},
+  {"trip cleared", eClearTrip, 0, 0, false, false, 4},
+  {"x needle again", eTouchControl, 4, 1, false, false, 1}              // p4DisplayBtn
+};
+
+#define VNUMPHASES (sizeof(GScript) / sizeof(GScript[0]))
+
+
+//
+// set the ATU model for one tick: on transmit, a speech like forward power
+//
+void SetATUState(const SPhase* Phase, unsigned long PhaseTick)
+{
+  GPTTPressed = Phase -> PTT;
+  if(GTuneActive && !Phase -> Tune)
+    GValidSolution = true;                    // tune finished
+  GTuneActive = Phase -> Tune;
+  if(Phase -> Tune)
+  {
+    GForwardPower = 10;
+    GVSWR = 1.0 + 3.0 * exp(-(double)PhaseTick / 40.0);
+    GValidSolution = false;
+  }
+  else if(Phase -> PTT)
+  {
+    GForwardPower = (unsigned int)(50 + 45 * sin(PhaseTick * 0.37) * sin(PhaseTick * 0.05));
+    GVSWR = 1.3 + 0.2 * sin(PhaseTick * 0.11);
+    GValidSolution = true;
+  }
+  else
+  {
+    GForwardPower = 0;
+    GVSWR = 1.0;
+  }
+  GPACurrent = GForwardPower / 4;
+}
+
+
+//
+// run one 16ms tick: the UI tick, then the main loop servicing the link until the next tick
+//
+//
+// check the status text on the pages that show it (p1t0-p4t0) is up to date
+// (until it is first sent after a page change, the page is still being filled in: not checked)
+//
+void CheckStatus(void)
+{
+  char Name[10];
+  std::map<std::string, std::string>::iterator It;
+
+  if((GDisplay.Page < 1) || (GDisplay.Page > 4))
+    return;
+  snprintf(Name, sizeof(Name), "p%dt0.txt", GDisplay.Page);
+  It = GDisplay.Values[GDisplay.Page].find(Name);
+  if((It == GDisplay.Values[GDisplay.Page].end()) || (It -> second == std::string("\"") + GetStatusString() + "\""))
+    GStatusTicks = 0;
+  else if(++GStatusTicks > GStats.MaxStatusTicks)
+    GStats.MaxStatusTicks = GStatusTicks;
+}
+
+
+void RunTick(unsigned long long TickStart)
+{
+  GStats.TickBytes = 0;
+  GStats.TickCommands = 0;
+  if(GNanos < TickStart)
+    GNanos = TickStart;
+  LCD_UI_Tick();
+  if(GNanos > TickStart + VTICKNANOS)
+    GStats.LateTicks++;
+  while(GNanos < TickStart + VTICKNANOS)
+  {
+    LCD_UI_Service();
+    GNanos += VSERVICENANOS;
+    UpdateLink();
+  }
+  if(GStats.TickBytes > GStats.MaxTickBytes)
+    GStats.MaxTickBytes = GStats.TickBytes;
+  if(GStats.TickCommands > GStats.MaxTickCommands)
+    GStats.MaxTickCommands = GStats.TickCommands;
+  CheckStatus();
+  GTick++;
+}
+
+
+void ShowValues(void)
+{
+  std::map<std::string, std::string>::iterator It;
+
+  for(It = GDisplay.Values[GDisplay.Page].begin(); It != GDisplay.Values[GDisplay.Page].end(); It++)
+    printf("      %s=%s\n", It -> first.c_str(), It -> second.c_str());
+}
+
+
+//
+// display power on: it starts on page 0 at the HMI file's rate, acknowledging failures only
+//
+void DisplayPowerOn(void)
+{
+  GDisplay.Page = 0;
+  GDisplay.BkCmd = 2;
+  GDisplay.Baud = 115200;
+  GDisplay.Command.clear();
+  GDisplay.FFCount = 0;
+  GDisplay.Garbled = false;
+}
+
+
+//
+// report the time taken to connect to the display, and the rate found
+//
+void ReportConnection(const char* Name, unsigned long long Start)
+{
+  printf("%-30s %7lu baud %8.1f ms\n", Name, GMCUBaud, (GNanos - Start) / 1000000.0);
+  if(!GNexDisplayPresent)
+    Error(std::string("display not found: ") + Name);
+  else if(GMCUBaud != GDisplay.Baud)
+    Error(std::string("display and processor rates differ: ") + Name);
+}
+
+
+int main(int argc, char** argv)
+{
+  unsigned long PhaseTicks = 500;
+  bool ShowState = false;
+  unsigned long long TickStart, Start;
+  unsigned long Cntr;
+  unsigned int Phase;
+  int Arg;
+  double Ticks;
+  char Str[80];
+
+  for(Arg = 1; Arg < argc; Arg++)
+  {
+    if((strcmp(argv[Arg], "-n") == 0) && (Arg + 1 < argc))
+      PhaseTicks = atol(argv[++Arg]);
+    else if((strcmp(argv[Arg], "-l") == 0) && (Arg + 1 < argc))
+      GPanelLimit = atol(argv[++Arg]);
+    else if(strcmp(argv[Arg], "-c") == 0)
+      GListCommands = true;
+    else if(strcmp(argv[Arg], "-v") == 0)
+      ShowState = true;
+    else
+    {
+      printf("usage: nextionemu [-n ticks per phase] [-l panel limit baud] [-c] [-v]\n");
+      return 2;
+    }
+  }
+
+//
+// connect at power on with no link rate saved; at power on again, with the rate saved;
+// and after a processor reset, with the display still at the negotiated rate
+//
+  DisplayPowerOn();
+  Start = GNanos;
+  LCD_UI_Initialise();
+  ReportConnection("power on, no rate saved", Start);
+  DisplayPowerOn();
+  Start = GNanos;
+  GNexDisplayPresent = ConnectDisplay();
+  ReportConnection("power on, rate saved", Start);
+  Start = GNanos;
+  GNexDisplayPresent = ConnectDisplay();
+  ReportConnection("processor reset", Start);
+  printf("\n");
+
+  printf("%-22s %4s %6s %10s %6s %10s %6s %6s %5s %6s\n", "phase", "page", "ticks", "bytes/tick", "max", "cmds/tick", "max", "link%", "late", "status");
+  TickStart = (GNanos / VTICKNANOS + 1) * VTICKNANOS;
+  for(Phase = 0; Phase < VNUMPHASES; Phase++)
+  {
+    memset(&GStats, 0, sizeof(GStats));
+    switch(GScript[Phase].Action)
+    {
+      case eNoAction:
+        break;
+      case eTouchControl:
+        Touch(GScript[Phase].Page, GScript[Phase].Component);
+        break;
+      case eTrip:
+        GIsTripped = true;
+        GTripInputBits = 0b0001;
+        SetPATrippedScreen(true);
+        break;
+      case eClearTrip:
+        GIsTripped = false;
+        GTripInputBits = 0;
+        SetPATrippedScreen(false);
+        break;
+    }
+    for(Cntr = 0; Cntr < PhaseTicks; Cntr++)
+    {
+      SetATUState(GScript + Phase, Cntr);
+      RunTick(TickStart);
+      TickStart += VTICKNANOS;
+    }
+    Ticks = (double)PhaseTicks;
+    printf("%-22s %4d %6lu %10.1f %6u %10.2f %6u %6.1f %5u %6u\n", GScript[Phase].Name, GDisplay.Page, PhaseTicks,
+           GStats.Bytes / Ticks, GStats.MaxTickBytes, GStats.Commands / Ticks, GStats.MaxTickCommands,
+           100.0 * GStats.Bytes * ByteNanos(GMCUBaud) / (Ticks * VTICKNANOS), GStats.LateTicks, GStats.MaxStatusTicks);
+    if(ShowState)
+      ShowValues();
+    if(GDisplay.Page != GScript[Phase].ExpectedPage)
+    {
+      snprintf(Str, sizeof(Str), "phase \"%s\" ended on page %d, not %d", GScript[Phase].Name, GDisplay.Page, GScript[Phase].ExpectedPage);
+      Error(Str);
+    }
+    if(GStats.MaxStatusTicks > VMAXSTATUSTICKS)
+    {
+      snprintf(Str, sizeof(Str), "phase \"%s\": status shown %u ticks late", GScript[Phase].Name, GStats.MaxStatusTicks);
+      Error(Str);
+    }
+  }
+
+  if(GErrors != 0)
+  {
+    printf("\n%d errors:\n", GErrors);
+    for(Arg = 0; (Arg < GErrors) && (Arg < VMAXERRORS); Arg++)
+      printf("  %s\n", GErrorMessages[Arg].c_str());
+    return 1;
+  }
+  printf("\nno errors\n");
+  return 0;
+}
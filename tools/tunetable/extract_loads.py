@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+#
+# Aries ATU tune table optimiser: make the load corpus from the test results
+# reads the "Antenna analyser" tables in measurements/*.xlsx: each block starts with
+# a "<f> MHz" row, followed by rows for the test loads ("8:1 Low" ... "1:1" ... "8:1 High").
+# The test loads are resistors (see documentation/test loads.xlsx):
+# low side loads are 50/N ohms, high side loads are 50*N ohms.
+#
+# usage: extract_loads.py [xlsx files...] > loads.csv
+# with no files given, reads all of measurements/*.xlsx
+#
+import glob
+import os
+import re
+import sys
+import zipfile
+
+VZ0 = 50.0
+
+
+def read_sheets(path):
+    # returns a list of sheets; each is a list of rows; each row is a dict column -> text
+    z = zipfile.ZipFile(path)
+    strings = []
+    if 'xl/sharedStrings.xml' in z.namelist():
+        for si in re.findall(r'<si>(.*?)</si>', z.read('xl/sharedStrings.xml').decode('utf-8'), re.S):
+            strings.append(''.join(re.findall(r'<t[^>]*>([^<]*)</t>', si)))
+    sheets = []
+    for name in sorted(n for n in z.namelist() if re.match(r'xl/worksheets/sheet\d+\.xml$', n)):
+        rows = []
+        for row in re.findall(r'<row[^>]*>(.*?)</row>', z.read(name).decode('utf-8'), re.S):
+            cells = {}
+            for attrs, body in re.findall(r'<c ([^>]*?)(?:/>|>(.*?)</c>)', row, re.S):
+                ref = re.search(r'r="([A-Z]+)\d+"', attrs).group(1)
+                value = re.search(r'<v>([^<]*)</v>', body or '')
+                if value:
+                    text = value.group(1)
+                    if 't="s"' in attrs:
+                        text = strings[int(text)]
+                    cells[ref] = text.strip()
+            rows.append(cells)
+        sheets.append(rows)
+    return sheets
+
+
+def extract(path):
+    loads = []
+    for sheet in read_sheets(path):
+        freq = None
+        high = False
+        for cells in sheet:
+            first = cells.get('A', '')
+            match = re.match(r'^([\d.]+)\s*MHz$', first)
+            if match:
+                freq = float(match.group(1))
+                high = False
+                continue
+            match = re.match(r'^(\d+):1\s*(Low|High)?$', first)
+            if freq is None or not match:
+                continue
+            if match.group(2) == 'High':
+                high = True
+            elif match.group(2) == 'Low':
+                high = False
+            ratio = float(match.group(1))
+            r = VZ0 * ratio if high else VZ0 / ratio
+            loads.append((freq, r, os.path.basename(path)))
+    return loads
+
+
+def main():
+    files = sys.argv[1:]
+    if not files:
+        root = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'measurements')
+        files = sorted(glob.glob(os.path.join(root, '*.xlsx')))
+    seen = set()
+    print('# Aries ATU load corpus: frequency (MHz), R (ohms), X (ohms)')
+    print('# made by extract_loads.py from ' + ', '.join(os.path.basename(f) for f in files))
+    for path in files:
+        for freq, r, source in extract(path):
+            if (freq, r) in seen:
+                continue
+            seen.add((freq, r))
+            print('%g,%g,0' % (freq, r))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,4 @@
+//
+// Aries ATU tune table optimiser: the sketch includes the core header with either case
+//
+#include "arduino.h"
@@ -0,0 +1,39 @@
+//
+// Aries ATU tune table optimiser
+// minimal host replacement for the Arduino core header,
+// enough to build the algorithm sources on a PC
+//
+#ifndef __host_arduino_h
+#define __host_arduino_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef uint8_t byte;
+
+#ifndef min
+#define min(a,b) ((a)<(b)?(a):(b))
+#define max(a,b) ((a)>(b)?(a):(b))
+#endif
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+
+
+//
+// serial port: debug output is discarded
+//
+class HardwareSerial
+{
+  public:
+    size_t print(const char*) {return 0;}
+    size_t print(long) {return 0;}
+    size_t println(void) {return 0;}
+    size_t println(const char*) {return 0;}
+    size_t println(long) {return 0;}
+};
+extern HardwareSerial Serial;
+
+unsigned long millis(void);
+
+#endif
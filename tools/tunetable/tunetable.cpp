@@ -0,0 +1,581 @@
+/////////////////////////////////////////////////////////////////////////
+//
+// Aries ATU controller sketch by Laurence Barker G8NJJ
+// this sketch controls an L-match ATU network
+// with a CAT interface to connect to an HPSDR control program
+// copyright (c) Laurence Barker G8NJJ 2019
+//
+// tunetable.cpp: host tool to optimise the tune tables (sketch/aries_sketch/tunetables.h)
+//
+// the algorithm sources are built into this program unchanged, with the tables
+// made writable. Each tune is run by the real state machine against a load modelled
+// with the L network component values from lnetwork.cpp. For each band it then
+// searches the table parameters (stage 1 sweep step, fixed values and number of rows;
+// stage 1b, mid and fine step and ranges) to minimise the mean tune time,
+// keeping the tune success rate at or above a floor.
+//
+// the corpus is the measured test loads (loads.csv, made by extract_loads.py)
+// plus a set of synthetic complex loads at each band.
+//
+// build (from this directory):
+//   g++ -O2 -std=gnu++11 -Ihost -I../../sketch/aries_sketch tunetable.cpp -o tunetable
+// run:
+//   ./tunetable [-l loads.csv] [-s strategy] [-f floor%] [-n] [-o tunetables.h]
+/////////////////////////////////////////////////////////////////////////
+
+#define TUNETABLE_CONST                 // make the tables writable
+#define VMAXBANDTRIES 3                 // max stage 1 "tries" per band (4 rows each)
+#define VSTAGE1SPARE (VMAXBANDTRIES * 4 * VNUMTUNEROWS)   // room in the stage 1 table to add tries
+
+#include <stdio.h>
+#include <complex>
+#include <vector>
+
+#include "algorithm.cpp"
+#include "patternsearch.cpp"
+#include "lnetwork.cpp"
+#include "formatter.cpp"
+
+
+#define VTICKMS 16                      // main tick period (ms)
+#define VMAXTUNETICKS 20000             // give up on a tune after this many ticks
+#define VTARGETVSWR 1.5                 // a tune is successful if the modelled VSWR is below this
+#define VMAXPASSES 4                    // max passes of the parameter search for each band
+
+
+typedef std::complex<double> cplx;
+
+
+//
+// structure for one load in the corpus
+//
+struct SLoad
+{
+  double FreqMHz;
+  cplx Z;                               // load impedance (ohms)
+};
+
+
+//
+// structure for the searched parameters of one band
+// each stage 1 "try" is 4 rows: loZ step C, loZ step L, hiZ step C, hiZ step L,
+// with the parameter not stepped fixed at Try * FixedStep
+//
+#define VNUMBANDPARAMS 7
+struct SBandParams
+{
+  int Tries;                            // number of stage 1 tries (rows / 4)
+  int FixedStep;                        // step of the fixed value between tries
+  int SweepStep;                        // stage 1 sweep step
+  int Stage1bStep;
+  int MidRange;
+  int MidStep;
+  int FineRange;
+};
+
+const char* GParamNames[VNUMBANDPARAMS] = {"tries", "fixed step", "stage 1 step", "stage 1b step", "mid range", "mid step", "fine range"};
+
+
+//
+// result of running a set of tunes
+//
+struct SScore
+{
+  int NumTunes;
+  int NumOK;
+  double MeanTimeMs;
+};
+
+
+//
+// host replacements for the sketch globals and functions the algorithm uses
+//
+HardwareSerial Serial;
+unsigned long GMillis;
+unsigned long millis(void) {return GMillis;}
+
+bool GStandaloneMode, GResendSPI, GSPIShiftInProgress;
+unsigned int GVf, GVr;
+float GVSWR = 1.0;
+unsigned int GForwardPower = 10;
+float GForwardWatts = 10.0;
+unsigned int GPACurrent;
+volatile bool GPTTPressed = true;
+volatile bool GPCTuneActive;
+bool GATUEnabled = true, GValidSolution;
+unsigned int GTunedFrequency10;
+byte GTXAntenna = 1;
+
+byte GHostL, GHostC;                    // relay settings driven
+bool GHostHighZ;
+cplx GHostLoad;                         // load being tuned
+double GHostOmega;                      // 2*pi*F (F in Hz)
+bool GHostTuneOK;                       // result reported by the algorithm
+byte GHostResultL, GHostResultC;
+bool GHostResultHighZ;
+
+bool GSharedSweeps[VNUMTUNEROWS];       // true if a row uses the stage 1 sweeps of the row before (general coverage)
+
+
+//
+// VSWR of the modelled L network and load
+//
+double ModelVSWR(byte L, byte C, bool HighZ)
+{
+  cplx ZL(0, GHostOmega * GetInductanceValue(L) * 1.0E-6);
+  cplx YC(0, GHostOmega * GetCapacitanceValue(C) * 1.0E-12);
+  cplx Zin;
+  double Gamma;
+
+  if(HighZ)                             // shunt C across the load, then series L
+    Zin = ZL + 1.0 / (YC + 1.0 / GHostLoad);
+  else                                  // series L with the load, then shunt C
+    Zin = 1.0 / (YC + 1.0 / (ZL + GHostLoad));
+  Gamma = std::abs((Zin - (double)VZ0) / (Zin + (double)VZ0));
+  if(Gamma > 0.98)
+    Gamma = 0.98;
+  return (1.0 + Gamma) / (1.0 - Gamma);
+}
+
+void SetInductance(byte Value) {GHostL = Value;}
+void SetCapacitance(byte Value) {GHostC = Value;}
+void SetHiLoZ(bool Value) {GHostHighZ = Value;}
+byte GetInductance(void) {return GHostL;}
+byte GetCapacitance(void) {return GHostC;}
+bool GetHiLoZ(void) {return GHostHighZ;}
+void SetNullSolution(void) {GHostL = 1; GHostC = 0; GHostHighZ = false;}
+void DriveSolution(void) {GVSWR = ModelVSWR(GHostL, GHostC, GHostHighZ);}
+unsigned int GetPowerReading(bool IsFwdPower) {return GForwardPower;}
+
+void SetTuneResult(bool Successful, byte Inductance, byte Capacitance, bool IsHighZ)
+{
+  GHostTuneOK = Successful;
+  GHostResultL = Inductance;
+  GHostResultC = Capacitance;
+  GHostResultHighZ = IsHighZ;
+}
+
+bool GetStoredSolution(int Frequency10, byte* L, byte* C, bool* HighZ) {return false;}
+void MakeCATMessageString(ECATCommands Cmd, const char* Param) {}
+
+
+
+//
+// run one full tune; returns true if successful, and the tune time
+//
+bool RunTune(const SLoad& Load, double* TimeMs)
+{
+  int Ticks = 0;
+
+  GHostLoad = Load.Z;
+  GHostOmega = 2.0 * M_PI * Load.FreqMHz * 1.0E6;
+  GTunedFrequency10 = (unsigned int)(Load.FreqMHz * 100.0 + 0.5);
+  FindFreqRow(GTunedFrequency10);
+  SetNullSolution();
+  DriveSolution();
+  GHostTuneOK = false;
+
+  InitiateTune(false);
+  while(GTuneActive && (Ticks < VMAXTUNETICKS))
+  {
+    GMillis += VTICKMS;
+    AlgorithmTick();
+    Ticks++;
+  }
+  CancelAlgorithm();
+  InitialiseAlgorithm();
+  *TimeMs = (double)Ticks * VTICKMS;
+  return GHostTuneOK && (ModelVSWR(GHostResultL, GHostResultC, GHostResultHighZ) < VTARGETVSWR);
+}
+
+
+//
+// run all the tunes for one band
+//
+SScore ScoreBand(const std::vector<SLoad>& Loads)
+{
+  SScore Score = {0, 0, 0.0};
+  double TimeMs;
+
+  for(size_t Cntr = 0; Cntr < Loads.size(); Cntr++)
+  {
+    if(RunTune(Loads[Cntr], &TimeMs))
+      Score.NumOK++;
+    Score.MeanTimeMs += TimeMs;
+    Score.NumTunes++;
+  }
+  if(Score.NumTunes != 0)
+    Score.MeanTimeMs /= Score.NumTunes;
+  return Score;
+}
+
+
+
+//
+// get the parameters for a band from the current tables
+//
+SBandParams GetBandParams(byte Band)
+{
+  SBandParams Params;
+  const STuneParams* Row = GTuneParamArray + Band;
+  const SSweepSet* Sweep = GStage1Array + Row -> Alg1StartRow;
+
+  Params.Tries = max(Row -> Alg1NumRows / 4, 1);
+  Params.FixedStep = (Params.Tries > 1) ? Sweep[4].FixedParam - Sweep[0].FixedParam : 1;
+  Params.SweepStep = Sweep[0].StepSize;
+  Params.Stage1bStep = Row -> Stage1bStep;
+  Params.MidRange = Row -> Stage2MidRange;
+  Params.MidStep = Row -> Stage2MidStep;
+  Params.FineRange = Row -> Stage2FineRange;
+  return Params;
+}
+
+int* GetParam(SBandParams* Params, int Index)
+{
+  int* Ptrs[VNUMBANDPARAMS] = {&Params -> Tries, &Params -> FixedStep, &Params -> SweepStep, &Params -> Stage1bStep,
+                               &Params -> MidRange, &Params -> MidStep, &Params -> FineRange};
+  return Ptrs[Index];
+}
+
+
+//
+// check parameters are usable: steps within the sweep range, and the table size
+//
+bool ParamsValid(const SBandParams& Params, byte Max)
+{
+  return (Params.Tries >= 1) && (Params.Tries <= VMAXBANDTRIES)
+      && (Params.FixedStep >= 1) && (Params.FixedStep * (Params.Tries - 1) <= Max)
+      && (Params.SweepStep >= 1) && (Params.SweepStep <= Max / 2)
+      && (Params.Stage1bStep >= 1) && (Params.Stage1bStep <= Max / 2)
+      && (Params.MidRange >= 1) && (Params.MidRange <= 127)
+      && (Params.MidStep >= 1) && (Params.MidStep <= Params.MidRange)
+      && (Params.FineRange >= 1) && (Params.FineRange <= 127);
+}
+
+
+//
+// write the parameters for all bands into the tables
+// the stage 1 rows for each band are placed one after another;
+// general coverage rows are set the same as the band below
+// returns false if there are more stage 1 rows than the generated table holds
+//
+bool SetTables(const SBandParams* Params, const byte* SweepMax)
+{
+  byte Band, Try, Sweep;
+  byte Row = 0;
+  unsigned int FreqMax;
+  SSweepSet* Ptr;
+
+  for(Band = 0; Band < VNUMTUNEROWS; Band++)
+  {
+    if(GSharedSweeps[Band])
+    {
+      FreqMax = GTuneParamArray[Band].FreqMax;
+      GTuneParamArray[Band] = GTuneParamArray[Band-1];
+      GTuneParamArray[Band].FreqMax = FreqMax;
+      continue;
+    }
+    GTuneParamArray[Band].Alg1StartRow = Row;
+    GTuneParamArray[Band].Alg1NumRows = Params[Band].Tries * 4;
+    GTuneParamArray[Band].Stage1bStep = Params[Band].Stage1bStep;
+    GTuneParamArray[Band].Stage2MidRange = Params[Band].MidRange;
+    GTuneParamArray[Band].Stage2MidStep = Params[Band].MidStep;
+    GTuneParamArray[Band].Stage2FineRange = Params[Band].FineRange;
+    if(Row + Params[Band].Tries * 4 > (int)(sizeof(GStage1Array) / sizeof(GStage1Array[0])))
+      return false;
+    for(Try = 0; Try < Params[Band].Tries; Try++)
+      for(Sweep = 0; Sweep < 4; Sweep++)
+      {
+        Ptr = GStage1Array + Row++;
+        Ptr -> IsHighZ = (Sweep >= 2);
+        Ptr -> IsSweepingL = (Sweep & 1);
+        Ptr -> MinSteppedValue = 0;
+        Ptr -> MaxSteppedValue = SweepMax[Band];
+        Ptr -> StepSize = Params[Band].SweepStep;
+        Ptr -> FixedParam = Try * Params[Band].FixedStep;
+      }
+  }
+  return true;
+}
+
+
+//
+// is score A better than score B, given the success floor?
+// a score below the floor is only better if it has more successes
+//
+bool IsBetter(const SScore& A, const SScore& B, int FloorOK)
+{
+  if(A.NumOK < FloorOK)
+    return A.NumOK > B.NumOK;
+  if(B.NumOK < FloorOK)
+    return true;
+  return A.MeanTimeMs < B.MeanTimeMs;
+}
+
+
+//
+// search the parameters for one band: coordinate descent,
+// trying a few smaller and larger values of each parameter in turn
+//
+SScore OptimiseBand(byte Band, SBandParams* Params, const byte* SweepMax, const std::vector<SLoad>& Loads, int FloorOK)
+{
+  SBandParams AllParams[VNUMTUNEROWS];
+  SBandParams Trial;
+  SScore Best, Score;
+  int Pass, Param, Cntr, Value;
+  bool Improved = true;
+
+  for(Cntr = 0; Cntr < VNUMTUNEROWS; Cntr++)
+    AllParams[Cntr] = Params[Cntr];
+  Best = ScoreBand(Loads);
+  for(Pass = 0; (Pass < VMAXPASSES) && Improved; Pass++)
+  {
+    Improved = false;
+    for(Param = 0; Param < VNUMBANDPARAMS; Param++)
+    {
+      Value = *GetParam(&AllParams[Band], Param);
+      int Candidates[6] = {Value - 1, Value + 1, Value * 3 / 4, (Value * 4 + 2) / 3, Value / 2, Value * 2};
+      for(Cntr = 0; Cntr < 6; Cntr++)
+      {
+        Trial = AllParams[Band];
+        *GetParam(&Trial, Param) = Candidates[Cntr];
+        if((Candidates[Cntr] == Value) || !ParamsValid(Trial, SweepMax[Band]))
+          continue;
+        Params[Band] = Trial;
+        if(!SetTables(Params, SweepMax))
+        {
+          Params[Band] = AllParams[Band];
+          continue;
+        }
+        Score = ScoreBand(Loads);
+        if(IsBetter(Score, Best, FloorOK))
+        {
+          fprintf(stderr, "  %s %d -> %d: %d/%d ok, %.0fms\n", GParamNames[Param], Value, Candidates[Cntr],
+                  Score.NumOK, Score.NumTunes, Score.MeanTimeMs);
+          Best = Score;
+          AllParams[Band] = Trial;
+          Improved = true;
+        }
+      }
+      Params[Band] = AllParams[Band];
+      SetTables(Params, SweepMax);
+    }
+  }
+  return Best;
+}
+
+
+
+//
+// read the load corpus: lines of frequency (MHz), R, X; # for comments
+//
+bool ReadLoads(const char* FileName, std::vector<SLoad>* Loads)
+{
+  FILE* File;
+  char Line[128];
+  double F, R, X;
+  SLoad Load;
+
+  File = fopen(FileName, "r");
+  if(File == NULL)
+    return false;
+  while(fgets(Line, sizeof(Line), File) != NULL)
+  {
+    if((Line[0] == '#') || (sscanf(Line, "%lf,%lf,%lf", &F, &R, &X) != 3))
+      continue;
+    Load.FreqMHz = F;
+    Load.Z = cplx(R, X);
+    Loads -> push_back(Load);
+  }
+  fclose(File);
+  return true;
+}
+
+
+//
+// add synthetic loads: a spread of R, and reactances either side, at each band
+//
+void AddSyntheticLoads(std::vector<SLoad>* Loads)
+{
+  const double Freqs[] = {1.85, 3.7, 5.35, 7.1, 10.12, 14.2, 18.1, 21.2, 24.9, 28.5, 50.5};
+  const double Rs[] = {5.0, 8.0, 12.5, 20.0, 33.0, 50.0, 75.0, 125.0, 200.0, 330.0, 500.0};
+  const double XRatios[] = {0.0, -0.5, 0.5, -1.5, 1.5};
+  SLoad Load;
+
+  for(size_t F = 0; F < sizeof(Freqs) / sizeof(Freqs[0]); F++)
+    for(size_t R = 0; R < sizeof(Rs) / sizeof(Rs[0]); R++)
+      for(size_t X = 0; X < sizeof(XRatios) / sizeof(XRatios[0]); X++)
+      {
+        Load.FreqMHz = Freqs[F];
+        Load.Z = cplx(Rs[R], Rs[R] * XRatios[X]);
+        Loads -> push_back(Load);
+      }
+}
+
+
+
+//
+// get a description of a table row's frequency range
+//
+void GetRowName(byte Row, char* Name)
+{
+  double Low = (Row == 0) ? 0.0 : GTuneParamArray[Row-1].FreqMax / 100.0;
+
+  if(GTuneParamArray[Row].FreqMax == 65535)
+    sprintf(Name, "above %gMHz", Low);
+  else
+    sprintf(Name, "%g-%gMHz", Low, GTuneParamArray[Row].FreqMax / 100.0);
+}
+
+
+//
+// write the band descriptors as a drop in replacement for tunetables.h
+//
+void WriteHeader(FILE* File, const SBandParams* Params, const byte* SweepMax, const SScore* Before, const SScore* After)
+{
+  const STuneParams* Row;
+  char Name[40];
+  char Line[80];
+  byte Band;
+
+  fprintf(File, "/////////////////////////////////////////////////////////////////////////\n");
+  fprintf(File, "//\n");
+  fprintf(File, "// Aries ATU controller sketch by Laurence Barker G8NJJ\n");
+  fprintf(File, "// this sketch controls an L-match ATU network\n");
+  fprintf(File, "// with a CAT interface to connect to an HPSDR control program\n");
+  fprintf(File, "// copyright (c) Laurence Barker G8NJJ 2019\n");
+  fprintf(File, "//\n");
+  fprintf(File, "// the code is written for an Arduino Nano 33 IoT module\n");
+  fprintf(File, "//\n");
+  fprintf(File, "// tunetables.h: frequency dependent tables for the tune algorithm\n");
+  fprintf(File, "// the band descriptors; the tables themselves are generated from these by tablegen.h\n");
+  fprintf(File, "// this file was generated by tools/tunetable\n");
+  fprintf(File, "// modelled result per band (successful tunes, mean tune time) before -> after:\n");
+  for(Band = 0; Band < VNUMTUNEROWS; Band++)
+  {
+    if(Before[Band].NumTunes == 0)
+      continue;
+    GetRowName(Band, Name);
+    fprintf(File, "//   %-16s %3d/%3d %6.0fms -> %3d/%3d %6.0fms\n", Name,
+            Before[Band].NumOK, Before[Band].NumTunes, Before[Band].MeanTimeMs,
+            After[Band].NumOK, After[Band].NumTunes, After[Band].MeanTimeMs);
+  }
+  fprintf(File, "/////////////////////////////////////////////////////////////////////////\n");
+  fprintf(File, "#ifndef __tunetables_h\n#define __tunetables_h\n\n\n");
+  fprintf(File, "//\n// band descriptors: one row per amateur band, with general coverage rows between.\n");
+  fprintf(File, "// the GTuneParamArray row is found by binary search on FreqMax (10KHz units),\n");
+  fprintf(File, "// so rows must be in ascending frequency order.\n");
+  fprintf(File, "// each band row has its own set of stage 1 sweeps; general coverage rows (#tries=0) use the band below.\n");
+  fprintf(File, "// the entire algorithm can be changed by replacing this table\n//\n");
+  fprintf(File, "#define VNUMTUNEROWS %d               // this tells how far to step\n", VNUMTUNEROWS);
+  fprintf(File, "constexpr SBandDescriptor GBandDescriptors[VNUMTUNEROWS] = \n");
+  fprintf(File, "// FMax, Lmax, Cmax, #tries, S1Max, S1Step, S1Fixed, S1bStep, S2Mid+-, S2MidStep, S2Fine+- \n{\n");
+  for(Band = 0; Band < VNUMTUNEROWS; Band++)
+  {
+    Row = GTuneParamArray + Band;
+    GetRowName(Band, Name);
+    if(GSharedSweeps[Band])
+      sprintf(Line, "  {%u, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},", Row -> FreqMax);
+    else
+      sprintf(Line, "  {%u, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d},", Row -> FreqMax, Row -> LMax, Row -> CMax,
+              Params[Band].Tries, SweepMax[Band], Params[Band].SweepStep, (Params[Band].Tries > 1) ? Params[Band].FixedStep : 0,
+              Params[Band].Stage1bStep, Params[Band].MidRange, Params[Band].MidStep, Params[Band].FineRange);
+    fprintf(File, "%-52s// %s %s\n", Line, GSharedSweeps[Band] ? "general coverage" : "band:", Name);
+  }
+  fprintf(File, "};\n\n\n#endif\n");
+}
+
+
+
+int main(int argc, char** argv)
+{
+  const char* LoadFile = "loads.csv";
+  const char* OutFile = NULL;
+  bool Synthetic = true;
+  int Strategy = 0;
+  double FloorPercent = -1.0;               // default: no worse than the current tables
+  std::vector<SLoad> Loads;
+  std::vector<SLoad> BandLoads[VNUMTUNEROWS];
+  SBandParams Params[VNUMTUNEROWS];
+  byte SweepMax[VNUMTUNEROWS];
+  SScore Before[VNUMTUNEROWS], After[VNUMTUNEROWS];
+  int Arg, FloorOK;
+  byte Band;
+  FILE* File;
+
+  for(Arg = 1; Arg < argc; Arg++)
+  {
+    if(!strcmp(argv[Arg], "-l") && (Arg + 1 < argc))
+      LoadFile = argv[++Arg];
+    else if(!strcmp(argv[Arg], "-o") && (Arg + 1 < argc))
+      OutFile = argv[++Arg];
+    else if(!strcmp(argv[Arg], "-s") && (Arg + 1 < argc))
+      Strategy = atoi(argv[++Arg]);
+    else if(!strcmp(argv[Arg], "-f") && (Arg + 1 < argc))
+      FloorPercent = atof(argv[++Arg]);
+    else if(!strcmp(argv[Arg], "-n"))
+      Synthetic = false;
+    else
+    {
+      fprintf(stderr, "usage: %s [-l loads.csv] [-s strategy] [-f floor%%] [-n] [-o tunetables.h]\n", argv[0]);
+      fprintf(stderr, "  -n: don't add synthetic loads; -f: min success rate (default: as current tables)\n");
+      return 1;
+    }
+  }
+
+  if(!ReadLoads(LoadFile, &Loads))
+    fprintf(stderr, "can't read %s: synthetic loads only\n", LoadFile);
+  if(Synthetic)
+    AddSyntheticLoads(&Loads);
+  for(Band = 0; Band < VNUMTUNEROWS; Band++)
+    GSharedSweeps[Band] = (Band != 0) && (GTuneParamArray[Band].Alg1StartRow == GTuneParamArray[Band-1].Alg1StartRow);
+  for(size_t Cntr = 0; Cntr < Loads.size(); Cntr++)
+  {
+    FindFreqRow((unsigned int)(Loads[Cntr].FreqMHz * 100.0 + 0.5));
+    Band = GFreqRow;
+    while(GSharedSweeps[Band])                // tuned with the band below's parameters
+      Band--;
+    BandLoads[Band].push_back(Loads[Cntr]);
+  }
+
+  InitialiseAlgorithm();
+  SetResumeTime(0);                         // each tune starts afresh
+  SetTuneStrategy(Strategy);
+  fprintf(stderr, "%d loads; strategy %s\n", (int)Loads.size(), GetTuneStrategyName(Strategy));
+  for(Band = 0; Band < VNUMTUNEROWS; Band++)
+  {
+    Params[Band] = GetBandParams(Band);
+    SweepMax[Band] = GStage1Array[GTuneParamArray[Band].Alg1StartRow].MaxSteppedValue;
+  }
+  SetTables(Params, SweepMax);
+
+  for(Band = 0; Band < VNUMTUNEROWS; Band++)
+  {
+    Before[Band] = ScoreBand(BandLoads[Band]);
+    After[Band] = Before[Band];
+    if(GSharedSweeps[Band] || (Before[Band].NumTunes == 0))
+      continue;
+    if(FloorPercent < 0.0)
+      FloorOK = Before[Band].NumOK;
+    else
+      FloorOK = (int)ceil(FloorPercent * Before[Band].NumTunes / 100.0);
+    fprintf(stderr, "band %d: %d/%d ok, %.0fms; floor %d\n", Band, Before[Band].NumOK, Before[Band].NumTunes,
+            Before[Band].MeanTimeMs, FloorOK);
+    After[Band] = OptimiseBand(Band, Params, SweepMax, BandLoads[Band], FloorOK);
+  }
+
+  File = stdout;
+  if(OutFile != NULL)
+  {
+    File = fopen(OutFile, "w");
+    if(File == NULL)
+    {
+      fprintf(stderr, "can't write %s\n", OutFile);
+      return 1;
+    }
+  }
+  WriteHeader(File, Params, SweepMax, Before, After);
+  if(File != stdout)
+    fclose(File);
+  return 0;
+}